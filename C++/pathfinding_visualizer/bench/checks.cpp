@@ -0,0 +1,310 @@
+#include "checks.hpp"
+
+#include "Core/ComponentMap.hpp"
+#include "Core/DStarLite.hpp"
+#include "Core/FlowField.hpp"
+#include "Core/GridMap.hpp"
+#include "Core/HierarchicalGraph.hpp"
+#include "Core/ParallelBfs.hpp"
+#include "Core/Search.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace pathfinding;
+
+namespace {
+
+struct CheckResult {
+    const char *name;
+    int cases = 0;
+    int mismatches = 0;
+    std::string firstMismatch;
+
+    void fail(const std::string &what) {
+        if (mismatches++ == 0) firstMismatch = what;
+    }
+};
+
+GridMap randomCheckMap(std::mt19937_64 &rng, int maxCost) {
+    std::uniform_int_distribution<int> side(1, 96);
+    const double densities[] = {0.0, 0.15, 0.3, 0.45};
+    GridMap grid(side(rng), side(rng));
+    std::bernoulli_distribution wall(densities[rng() % 4]);
+    std::uniform_int_distribution<int> cost(1, maxCost);
+    for (int i = 0; i < grid.size(); ++i) {
+        if (wall(rng)) grid.setCell(i, GridMap::Wall);
+        if (maxCost > 1) grid.setCost(i, static_cast<std::uint8_t>(cost(rng)));
+    }
+    return grid;
+}
+
+// A random free cell, or -1 on a map without one
+int randomFreeCell(const GridMap &grid, std::mt19937_64 &rng) {
+    std::vector<int> freeCells;
+    for (int i = 0; i < grid.size(); ++i)
+        if (!grid.isWall(i)) freeCells.push_back(i);
+    if (freeCells.empty()) return -1;
+    return freeCells[std::size_t(rng() % freeCells.size())];
+}
+
+/**
+ * A few random edits, as a user makes between two runs: wall toggles, and
+ * cost changes on weighted maps. The cells in keep are left alone.
+ */
+void editRandomCells(GridMap &grid, std::mt19937_64 &rng, int maxCost, std::initializer_list<int> keep) {
+    std::uniform_int_distribution<int> cell(0, grid.size() - 1);
+    std::uniform_int_distribution<int> cost(1, maxCost);
+    const int edits = 1 + int(rng() % 6);
+    for (int i = 0; i < edits; ++i) {
+        const int at = cell(rng);
+        if (std::find(keep.begin(), keep.end(), at) != keep.end()) continue;
+        if (maxCost > 1 && rng() % 2 == 0)
+            grid.setCost(at, static_cast<std::uint8_t>(cost(rng)));
+        else
+            grid.setCell(at, grid.isWall(at) ? GridMap::Free : GridMap::Wall);
+    }
+}
+
+// Whether path walks from start to target over free 4-neighbours and its cells after start cost pathCost
+bool validPath(const GridMap &grid, const SearchResult &result, int start, int target) {
+    const std::vector<int> &path = result.path;
+    if (path.empty() || path.front() != start || path.back() != target) return false;
+    int cost = 0;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        const int from = path[i - 1], to = path[i];
+        if (grid.isWall(to)) return false;
+        if (std::abs(grid.rowOf(from) - grid.rowOf(to)) + std::abs(grid.colOf(from) - grid.colOf(to)) != 1)
+            return false;
+        cost += grid.cost(to);
+    }
+    return cost == result.pathCost;
+}
+
+std::string describe(const GridMap &grid, unsigned long long seed, int map) {
+    std::ostringstream out;
+    out << "map " << map << " (" << grid.rows() << "x" << grid.cols() << ", seed " << seed << ")";
+    return out.str();
+}
+
+/**
+ * The level-synchronous field must equal the serial BFS field, whichever
+ * levels go bottom-up; alpha 1 / beta 2 switches on almost every level.
+ */
+CheckResult checkParallelBfs(unsigned long long seed, int maps, int threads) {
+    CheckResult check{"parallel-bfs"};
+    std::mt19937_64 rng(seed);
+    ParallelBfsOptions variants[3];
+    variants[1].directionOptimizing = false;
+    variants[2].alpha = 1;
+    variants[2].beta = 2;
+    for (int map = 0; map < maps; ++map) {
+        const GridMap grid = randomCheckMap(rng, 1);
+        const int source = randomFreeCell(grid, rng);
+        const int target = randomFreeCell(grid, rng);
+        if (source < 0) continue;
+        const std::vector<int> reference = bfsDistanceField(grid, source);
+        for (ParallelBfsOptions options : variants) {
+            options.threads = threads;
+            ++check.cases;
+            if (parallelBfsDistanceField(grid, source, options) != reference)
+                check.fail(describe(grid, seed, map) + ": distance field differs from serial BFS");
+        }
+
+        SearchOptions searchOptions;
+        searchOptions.threads = threads;
+        const SearchResult parallel = parallelBfs(grid, source, target, nullptr, searchOptions);
+        ++check.cases;
+        if (parallel.found != (reference[std::size_t(target)] != Unreachable)
+            || (parallel.found && parallel.pathCost != reference[std::size_t(target)]))
+            check.fail(describe(grid, seed, map) + ": parallelBfs path length differs from serial BFS");
+    }
+    return check;
+}
+
+// Edits applied to the map a check keeps its structure for, before each comparison
+const int kEditRounds = 8;
+
+/**
+ * A FlowField repaired after every few edits must hold the same distances
+ * as one built from scratch on the edited map.
+ */
+CheckResult checkFlowFieldRepair(unsigned long long seed, int maps) {
+    CheckResult check{"flow-field-repair"};
+    std::mt19937_64 rng(seed + 1);
+    int repaired = 0;
+    for (int map = 0; map < maps; ++map) {
+        GridMap grid = randomCheckMap(rng, map % 2 == 0 ? 1 : 9);
+        const int target = randomFreeCell(grid, rng);
+        if (target < 0) continue;
+        FlowField field;
+        field.update(grid, target);
+        for (int round = 0; round < kEditRounds; ++round) {
+            editRandomCells(grid, rng, grid.hasCosts() ? 9 : 1, {target});
+            if (field.update(grid, target).incremental) ++repaired;
+            FlowField fresh;
+            fresh.update(grid, target);
+            ++check.cases;
+            for (int i = 0; i < grid.size(); ++i) {
+                if (field.distance(i) == fresh.distance(i)) continue;
+                check.fail(describe(grid, seed + 1, map) + ", edit round " + std::to_string(round)
+                           + ": repaired distance of cell " + std::to_string(i) + " is "
+                           + std::to_string(field.distance(i)) + ", rebuilt " + std::to_string(fresh.distance(i)));
+                break;
+            }
+        }
+    }
+    if (check.cases > 0 && repaired == 0) check.fail("no update was repaired incrementally");
+    return check;
+}
+
+/**
+ * A D* Lite planner kept across edits and start moves must find paths as
+ * short as Dijkstra's on the current map, and real ones.
+ */
+CheckResult checkDStarLiteReplan(unsigned long long seed, int maps) {
+    CheckResult check{"dstar-lite-replan"};
+    std::mt19937_64 rng(seed + 2);
+    int replanned = 0;
+    for (int map = 0; map < maps; ++map) {
+        GridMap grid = randomCheckMap(rng, map % 2 == 0 ? 1 : 9);
+        int start = randomFreeCell(grid, rng);
+        const int target = randomFreeCell(grid, rng);
+        if (start < 0) continue;
+        DStarLite planner;
+        planner.plan(grid, start, target);
+        for (int round = 0; round < kEditRounds; ++round) {
+            editRandomCells(grid, rng, grid.hasCosts() ? 9 : 1, {start, target});
+            // Now and then the agent has moved on, as it does between two replans
+            if (round % 3 == 2) {
+                const int moved = randomFreeCell(grid, rng);
+                if (moved >= 0) start = moved;
+            }
+            const SearchResult planned = planner.plan(grid, start, target);
+            if (planner.lastPlan().incremental) ++replanned;
+            const SearchResult reference = dijkstra(grid, start, target);
+            ++check.cases;
+            const std::string where = describe(grid, seed + 2, map) + ", edit round " + std::to_string(round);
+            if (planned.found != reference.found || (planned.found && planned.pathCost != reference.pathCost))
+                check.fail(where + ": replanned cost " + (planned.found ? std::to_string(planned.pathCost) : "none")
+                           + ", Dijkstra " + (reference.found ? std::to_string(reference.pathCost) : "none"));
+            else if (planned.found && !validPath(grid, planned, start, target))
+                check.fail(where + ": replanned path is not a walk of its cost from start to target");
+        }
+    }
+    if (check.cases > 0 && replanned == 0) check.fail("no plan was repaired incrementally");
+    return check;
+}
+
+/**
+ * An HPA* graph whose edited clusters were rebuilt must answer like one
+ * built from scratch: the same path cost (HPA* is not optimal, but both
+ * graphs should be identical) and reachability as BFS sees it.
+ */
+CheckResult checkHierarchicalRepair(unsigned long long seed, int maps) {
+    CheckResult check{"hpa-repair"};
+    std::mt19937_64 rng(seed + 3);
+    int repaired = 0;
+    for (int map = 0; map < maps; ++map) {
+        GridMap grid = randomCheckMap(rng, map % 2 == 0 ? 1 : 9);
+        // Small clusters so that most random maps are cut into several
+        const int clusterSize = map % 3 == 0 ? HierarchicalGraph::DefaultClusterSize : 8;
+        HierarchicalGraph graph(clusterSize);
+        graph.update(grid);
+        for (int round = 0; round < kEditRounds; ++round) {
+            editRandomCells(grid, rng, grid.hasCosts() ? 9 : 1, {});
+            const int start = randomFreeCell(grid, rng);
+            const int target = randomFreeCell(grid, rng);
+            if (start < 0) continue;
+            const SearchResult repairedPath = graph.query(grid, start, target);
+            if (graph.lastUpdate().incremental) ++repaired;
+            HierarchicalGraph fresh(clusterSize);
+            const SearchResult rebuiltPath = fresh.query(grid, start, target);
+            const bool reachable = bfs(grid, start, target).found;
+            ++check.cases;
+            const std::string where = describe(grid, seed + 3, map) + ", edit round " + std::to_string(round);
+            if (repairedPath.found != reachable || rebuiltPath.found != reachable)
+                check.fail(where + ": found " + std::to_string(repairedPath.found) + " after repair, "
+                           + std::to_string(rebuiltPath.found) + " after rebuild, BFS " + std::to_string(reachable));
+            else if (repairedPath.found && repairedPath.pathCost != rebuiltPath.pathCost)
+                check.fail(where + ": path cost " + std::to_string(repairedPath.pathCost) + " after repair, "
+                           + std::to_string(rebuiltPath.pathCost) + " after rebuild");
+            else if (repairedPath.found && !validPath(grid, repairedPath, start, target))
+                check.fail(where + ": repaired path is not a walk of its cost from start to target");
+        }
+    }
+    if (check.cases > 0 && repaired == 0) check.fail("no update was repaired incrementally");
+    return check;
+}
+
+// A cell where the two maps cut the free cells into different regions (ids aside), or -1 if none
+int firstRegionMismatch(const GridMap &grid, const ComponentMap &a, const ComponentMap &b) {
+    std::map<int, int> aToB, bToA;
+    for (int i = 0; i < grid.size(); ++i) {
+        const int ca = a.component(i), cb = b.component(i);
+        if ((ca < 0) != grid.isWall(i) || (cb < 0) != grid.isWall(i)) return i;
+        if (ca < 0) continue;
+        if (aToB.emplace(ca, cb).first->second != cb || bToA.emplace(cb, ca).first->second != ca) return i;
+    }
+    return -1;
+}
+
+/**
+ * Region labels patched after wall edits must describe the same regions as
+ * labels built from scratch, with corner contacts joined and without.
+ */
+CheckResult checkComponentRepair(unsigned long long seed, int maps) {
+    CheckResult check{"component-repair"};
+    std::mt19937_64 rng(seed + 4);
+    int repaired = 0;
+    for (int map = 0; map < maps; ++map) {
+        GridMap grid = randomCheckMap(rng, 1);
+        const bool diagonal = map % 2 == 1;
+        ComponentMap components;
+        components.update(grid, diagonal);
+        for (int round = 0; round < kEditRounds; ++round) {
+            editRandomCells(grid, rng, 1, {});
+            if (components.update(grid, diagonal).incremental) ++repaired;
+            ComponentMap fresh;
+            fresh.update(grid, diagonal);
+            ++check.cases;
+            const std::string where = describe(grid, seed + 4, map) + ", edit round " + std::to_string(round)
+                                      + (diagonal ? ", diagonal" : "");
+            const int cell = firstRegionMismatch(grid, components, fresh);
+            if (cell >= 0)
+                check.fail(where + ": regions differ from a rebuild at cell " + std::to_string(cell));
+            else if (components.componentCount() != fresh.componentCount())
+                check.fail(where + ": " + std::to_string(components.componentCount()) + " regions after repair, "
+                           + std::to_string(fresh.componentCount()) + " after rebuild");
+        }
+    }
+    if (check.cases > 0 && repaired == 0) check.fail("no update was repaired incrementally");
+    return check;
+}
+
+} // namespace
+
+int runChecks(unsigned long long seed, int maps, int threads) {
+    const CheckResult checks[] = {
+        checkParallelBfs(seed, maps, threads),
+        checkFlowFieldRepair(seed, maps),
+        checkDStarLiteReplan(seed, maps),
+        checkHierarchicalRepair(seed, maps),
+        checkComponentRepair(seed, maps),
+    };
+    int failed = 0;
+    for (const CheckResult &check : checks) {
+        std::cout << check.name << ": " << check.cases << " cases, " << check.mismatches << " mismatches\n";
+        if (check.mismatches == 0) continue;
+        std::cout << "  first: " << check.firstMismatch << '\n';
+        ++failed;
+    }
+    return failed;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+/**
+ * pathfinding_bench --check: randomized equality checks of the parts of the
+ * core that take shortcuts, each against a plain reference on the same map.
+ * Every check runs over `maps` random maps drawn from seed and prints one
+ * line; the first mismatch of a check is described on the line after it.
+ *
+ * Returns the number of checks that failed (0 = all passed).
+ */
+int runChecks(unsigned long long seed, int maps, int threads);
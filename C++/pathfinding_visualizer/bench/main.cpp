@@ -0,0 +1,501 @@
+/**
+ * pathfinding_bench: headless benchmark for the pathfinding_core searches.
+ *
+ * Runs every selected algorithm over the same start/target pairs, taken from a
+ * MovingAI .scen file or generated from a seeded RNG, and reports throughput,
+ * latency percentiles, nodes expanded, peak memory and optimality against the
+ * BFS (unit costs) or Dijkstra (weighted maps) ground truth as CSV or JSON.
+ *
+ * Example:
+ *   pathfinding_bench --map arena.map --scen arena.map.scen --format json
+ *   pathfinding_bench --random 1000x1000 --density 0.3 --queries 200 --seed 7
+ *   pathfinding_bench --random 1000x1000 --max-cost 20 --algos dijkstra,astar
+ *   pathfinding_bench --random 4000x4000 --density 0.1 --algos bfs,pbfs --threads 8
+ *   pathfinding_bench --random 1000x1000 --algos astar,theta --counters --format json
+ *   pathfinding_bench --check --seed 3 --queries 200
+ */
+#include "checks.hpp"
+
+#include "Core/BatchSearch.hpp"
+#include "Core/GridMap.hpp"
+#include "Core/MapIO.hpp"
+#include "Core/Search.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace pathfinding;
+
+namespace {
+
+struct AlgorithmEntry {
+    const char *key;
+    Algorithm algo;
+};
+
+const AlgorithmEntry kAlgorithms[] = {
+    {"bfs", Algorithm::BFS},
+    {"dijkstra", Algorithm::Dijkstra},
+    {"astar", Algorithm::AStar},
+    {"jps", Algorithm::JPS},
+    {"jps-block", Algorithm::BlockJPS},
+    {"bibfs", Algorithm::BidirectionalBFS},
+    {"biastar", Algorithm::BidirectionalAStar},
+    {"pbfs", Algorithm::ParallelBFS},
+    {"flow", Algorithm::FlowField},
+    {"dstar", Algorithm::DStarLite},
+    {"hpa", Algorithm::HPA},
+    {"theta", Algorithm::ThetaStar},
+    {"lazytheta", Algorithm::LazyThetaStar},
+};
+
+struct QueueEntry {
+    const char *key;
+    QueueKind kind;
+};
+
+const QueueEntry kQueues[] = {
+    {"binary", QueueKind::BinaryHeap},
+    {"4ary", QueueKind::QuaternaryHeap},
+    {"bucket", QueueKind::BucketQueue},
+    {"radix", QueueKind::RadixHeap},
+};
+
+struct Options {
+    std::string mapPath;
+    std::string scenPath;
+    int randomRows = 0;
+    int randomCols = 0;
+    double density = 0.25;
+    int maxCost = 1;
+    int queries = 100;
+    unsigned long long seed = 1;
+    int repeat = 1;
+    int threads = 0;
+    bool batch = false;
+    Connectivity connectivity = Connectivity::Four;
+    CornerCutting corners = CornerCutting::Never;
+    bool reachability = true;
+    bool counters = false;
+    bool check = false; // run the equality checks (checks.hpp) instead of benchmarking
+    bool queriesSet = false;
+    std::vector<std::string> algos;
+    std::vector<std::string> queues;
+    std::string format = "csv";
+    std::string output;
+    std::string label;
+};
+
+struct Report {
+    std::string algo;
+    std::string queue;
+    int queries = 0;
+    int solved = 0;
+    int suboptimal = 0;
+    double maxCostRatio = 1.0;
+    double totalMs = 0.0;
+    double p50 = 0.0, p90 = 0.0, p99 = 0.0, maxMs = 0.0;
+    double meanExpanded = 0.0;
+    double meanGenerated = 0.0;
+    double peakRssMb = 0.0;
+    // Search contexts after the run, per map cell and thread; < 0 (printed empty) for the algorithms
+    // that take no context and keep per-thread structures of their own instead
+    double scratchBytesPerCell = -1.0;
+    // --counters: open-list traffic per query, largest open list and allocations over all queries
+    double meanPushes = 0.0, meanPops = 0.0, meanStalePops = 0.0;
+    std::int64_t peakOpen = 0;
+    std::int64_t bytesAllocated = 0;
+    double pathMs = 0.0; // path reconstruction, part of totalMs
+};
+
+void usage() {
+    std::cerr <<
+        "usage: pathfinding_bench --check [--seed S] [--queries MAPS] [--threads T]\n"
+        "       pathfinding_bench (--map FILE | --random ROWSxCOLS [--density P] [--max-cost C])\n"
+        "                         [--scen FILE | --queries N] [--seed S] [--repeat K] [--threads T] [--batch]\n"
+        "                         [--moves 4|8] [--corners never|one|always] [--no-reachability] [--counters]\n"
+        "                         [--algos bfs,dijkstra,astar,jps,jps-block,bibfs,biastar,pbfs,flow,dstar,hpa,theta,lazytheta] [--queues binary,4ary,bucket,radix]\n"
+        "                         [--format csv|json]\n"
+        "                         [--output FILE] [--label TEXT]\n";
+}
+
+double peakRssMb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return double(pmc.PeakWorkingSetSize) / (1024.0 * 1024.0);
+    return 0.0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    return double(usage.ru_maxrss) / (1024.0 * 1024.0); // bytes
+#else
+    return double(usage.ru_maxrss) / 1024.0; // kilobytes
+#endif
+#endif
+}
+
+std::vector<std::string> split(const std::string &s, char sep) {
+    std::vector<std::string> parts;
+    std::istringstream in(s);
+    std::string part;
+    while (std::getline(in, part, sep))
+        if (!part.empty()) parts.push_back(part);
+    return parts;
+}
+
+bool parseArgs(int argc, char **argv, Options &opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&](std::string &value) {
+            if (i + 1 >= argc) return false;
+            value = argv[++i];
+            return true;
+        };
+        std::string v;
+        if (arg == "--map" && next(v)) opt.mapPath = v;
+        else if (arg == "--scen" && next(v)) opt.scenPath = v;
+        else if (arg == "--random" && next(v)) {
+            if (std::sscanf(v.c_str(), "%dx%d", &opt.randomRows, &opt.randomCols) != 2) return false;
+        }
+        else if (arg == "--density" && next(v)) opt.density = std::atof(v.c_str());
+        else if (arg == "--max-cost" && next(v)) opt.maxCost = std::min(255, std::max(1, std::atoi(v.c_str())));
+        else if (arg == "--queries" && next(v)) { opt.queries = std::atoi(v.c_str()); opt.queriesSet = true; }
+        else if (arg == "--seed" && next(v)) opt.seed = std::strtoull(v.c_str(), nullptr, 10);
+        else if (arg == "--repeat" && next(v)) opt.repeat = std::max(1, std::atoi(v.c_str()));
+        else if (arg == "--threads" && next(v)) opt.threads = std::atoi(v.c_str());
+        else if (arg == "--batch") opt.batch = true;
+        else if (arg == "--no-reachability") opt.reachability = false;
+        else if (arg == "--counters") opt.counters = true;
+        else if (arg == "--check") opt.check = true;
+        else if (arg == "--moves" && next(v)) {
+            if (v == "4") opt.connectivity = Connectivity::Four;
+            else if (v == "8") opt.connectivity = Connectivity::Eight;
+            else return false;
+        }
+        else if (arg == "--corners" && next(v)) {
+            if (v == "never") opt.corners = CornerCutting::Never;
+            else if (v == "one") opt.corners = CornerCutting::OneSide;
+            else if (v == "always") opt.corners = CornerCutting::Always;
+            else return false;
+        }
+        else if (arg == "--algos" && next(v)) opt.algos = split(v, ',');
+        else if (arg == "--queues" && next(v)) opt.queues = split(v, ',');
+        else if (arg == "--format" && next(v)) opt.format = v;
+        else if (arg == "--output" && next(v)) opt.output = v;
+        else if (arg == "--label" && next(v)) opt.label = v;
+        else return false;
+    }
+    if (opt.check) return true;
+    if (opt.mapPath.empty() && (opt.randomRows <= 0 || opt.randomCols <= 0)) return false;
+    if (opt.format != "csv" && opt.format != "json") return false;
+    if (opt.algos.empty())
+        for (const auto &entry : kAlgorithms) opt.algos.push_back(entry.key);
+    if (opt.queues.empty())
+        opt.queues.push_back("binary");
+    return true;
+}
+
+const AlgorithmEntry *findAlgorithm(const std::string &key) {
+    for (const auto &entry : kAlgorithms)
+        if (key == entry.key) return &entry;
+    return nullptr;
+}
+
+const QueueEntry *findQueue(const std::string &key) {
+    for (const auto &entry : kQueues)
+        if (key == entry.key) return &entry;
+    return nullptr;
+}
+
+// BFS has a fixed FIFO frontier, so it is run once regardless of --queues
+bool usesOpenList(Algorithm algo) {
+    return algo != Algorithm::BFS && algo != Algorithm::BidirectionalBFS && algo != Algorithm::ParallelBFS
+        && algo != Algorithm::FlowField && algo != Algorithm::DStarLite && algo != Algorithm::HPA
+        && !isAnyAngle(algo); // always a binary heap
+}
+
+// The flow field, D* Lite and HPA* keep their own structures, so a context says nothing about them
+bool usesContext(Algorithm algo) {
+    return algo != Algorithm::FlowField && algo != Algorithm::DStarLite && algo != Algorithm::HPA;
+}
+
+// Empty in CSV, null in JSON, when there is no figure
+std::string scratchField(const Report &r, const char *none) {
+    if (r.scratchBytesPerCell < 0) return none;
+    std::ostringstream out;
+    out << r.scratchBytesPerCell;
+    return out.str();
+}
+
+GridMap randomMap(int rows, int cols, double density, int maxCost, std::mt19937_64 &rng) {
+    GridMap grid(rows, cols);
+    std::bernoulli_distribution wall(density);
+    std::uniform_int_distribution<int> cost(1, maxCost);
+    for (int i = 0; i < grid.size(); ++i) {
+        if (wall(rng)) grid.setCell(i, GridMap::Wall);
+        if (maxCost > 1) grid.setCost(i, static_cast<std::uint8_t>(cost(rng)));
+    }
+    return grid;
+}
+
+std::vector<BatchQuery> randomQueries(const GridMap &grid, int count, std::mt19937_64 &rng) {
+    std::vector<int> freeCells;
+    for (int i = 0; i < grid.size(); ++i)
+        if (!grid.isWall(i)) freeCells.push_back(i);
+    std::vector<BatchQuery> queries;
+    if (freeCells.empty()) return queries;
+    std::uniform_int_distribution<std::size_t> pick(0, freeCells.size() - 1);
+    for (int i = 0; i < count; ++i)
+        queries.push_back({freeCells[pick(rng)], freeCells[pick(rng)]});
+    return queries;
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const std::size_t rank = static_cast<std::size_t>(p * double(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void writeCsv(std::ostream &out, const Options &opt, const std::string &mapName, const std::vector<Report> &reports) {
+    out << "label,map,algorithm,open_list,queries,solved,total_ms,queries_per_s,p50_ms,p90_ms,p99_ms,max_ms,"
+           "mean_expanded,mean_generated,peak_rss_mb,scratch_bytes_per_cell,suboptimal,max_cost_ratio";
+    if (opt.counters) out << ",mean_pushes,mean_pops,mean_stale_pops,peak_open,bytes_allocated,path_ms";
+    out << '\n';
+    for (const Report &r : reports) {
+        out << opt.label << ',' << mapName << ',' << r.algo << ',' << r.queue << ',' << r.queries << ',' << r.solved << ','
+            << r.totalMs << ',' << (r.totalMs > 0 ? r.queries * 1000.0 / r.totalMs : 0.0) << ','
+            << r.p50 << ',' << r.p90 << ',' << r.p99 << ',' << r.maxMs << ','
+            << r.meanExpanded << ',' << r.meanGenerated << ',' << r.peakRssMb << ',' << scratchField(r, "") << ','
+            << r.suboptimal << ',' << r.maxCostRatio;
+        if (opt.counters)
+            out << ',' << r.meanPushes << ',' << r.meanPops << ',' << r.meanStalePops << ',' << r.peakOpen << ','
+                << r.bytesAllocated << ',' << r.pathMs;
+        out << '\n';
+    }
+}
+
+std::string jsonEscape(const std::string &s) {
+    std::string out;
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        out += ch;
+    }
+    return out;
+}
+
+void writeJson(std::ostream &out, const Options &opt, const std::string &mapName, const std::vector<Report> &reports) {
+    out << "{\n  \"label\": \"" << jsonEscape(opt.label) << "\",\n  \"map\": \"" << jsonEscape(mapName)
+        << "\",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < reports.size(); ++i) {
+        const Report &r = reports[i];
+        out << "    {\"algorithm\": \"" << r.algo << "\", \"open_list\": \"" << r.queue
+            << "\", \"queries\": " << r.queries
+            << ", \"solved\": " << r.solved << ", \"total_ms\": " << r.totalMs
+            << ", \"queries_per_s\": " << (r.totalMs > 0 ? r.queries * 1000.0 / r.totalMs : 0.0)
+            << ", \"latency_ms\": {\"p50\": " << r.p50 << ", \"p90\": " << r.p90
+            << ", \"p99\": " << r.p99 << ", \"max\": " << r.maxMs << "}"
+            << ", \"mean_expanded\": " << r.meanExpanded << ", \"mean_generated\": " << r.meanGenerated
+            << ", \"peak_rss_mb\": " << r.peakRssMb << ", \"scratch_bytes_per_cell\": " << scratchField(r, "null")
+            << ", \"suboptimal\": " << r.suboptimal << ", \"max_cost_ratio\": " << r.maxCostRatio;
+        if (opt.counters)
+            out << ", \"counters\": {\"mean_pushes\": " << r.meanPushes << ", \"mean_pops\": " << r.meanPops
+                << ", \"mean_stale_pops\": " << r.meanStalePops << ", \"peak_open\": " << r.peakOpen
+                << ", \"bytes_allocated\": " << r.bytesAllocated << ", \"path_ms\": " << r.pathMs << "}";
+        out << "}" << (i + 1 < reports.size() ? "," : "") << '\n';
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) { usage(); return 2; }
+    // --queries is the number of random maps per check there
+    if (opt.check) return runChecks(opt.seed, opt.queriesSet ? opt.queries : 50, opt.threads) == 0 ? 0 : 1;
+
+    std::mt19937_64 rng(opt.seed);
+    GridMap grid;
+    std::string mapName;
+    std::string error;
+    if (!opt.mapPath.empty()) {
+        if (!loadMap(opt.mapPath, grid, &error)) { std::cerr << error << '\n'; return 1; }
+        mapName = opt.mapPath;
+    } else {
+        grid = randomMap(opt.randomRows, opt.randomCols, opt.density, opt.maxCost, rng);
+        mapName = "random-" + std::to_string(opt.randomRows) + "x" + std::to_string(opt.randomCols);
+    }
+
+    std::vector<BatchQuery> queries;
+    if (!opt.scenPath.empty()) {
+        std::vector<Scenario> scenarios;
+        if (!loadMovingAiScenarios(opt.scenPath, scenarios, &error)) { std::cerr << error << '\n'; return 1; }
+        for (const Scenario &s : scenarios) {
+            if (!grid.inBounds(s.startY, s.startX) || !grid.inBounds(s.goalY, s.goalX)) continue;
+            queries.push_back({grid.index(s.startY, s.startX), grid.index(s.goalY, s.goalX)});
+        }
+    } else {
+        queries = randomQueries(grid, opt.queries, rng);
+    }
+    if (queries.empty()) { std::cerr << "no queries\n"; return 1; }
+
+    // Ground truth: BFS is exact on 4-connected unit-cost grids, otherwise Dijkstra
+    SearchOptions movement;
+    movement.connectivity = opt.connectivity;
+    movement.corners = opt.corners;
+    movement.reachabilityCheck = opt.reachability;
+    const bool bfsExact = !grid.hasCosts() && opt.connectivity == Connectivity::Four;
+    std::vector<int> optimal(queries.size(), -1);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const SearchResult truth = bfsExact
+            ? bfs(grid, queries[i].start, queries[i].target)
+            : dijkstra(grid, queries[i].start, queries[i].target, nullptr, movement);
+        if (truth.found) optimal[i] = truth.pathCost;
+    }
+
+    // Only built for --batch: its pool threads would otherwise sit idle
+    std::unique_ptr<BatchSearch> batch;
+    if (opt.batch) batch = std::make_unique<BatchSearch>(opt.threads);
+
+    std::vector<Report> reports;
+    // Any-angle paths straighten 8-connected grid paths without corner cutting; they count as
+    // suboptimal only when longer than that optimum (max_cost_ratio below 1 is the gain)
+    std::vector<int> gridOptimal;
+    auto anyAngleOptimal = [&]() -> const std::vector<int> & {
+        if (gridOptimal.empty()) {
+            SearchOptions eightWay;
+            eightWay.connectivity = Connectivity::Eight;
+            eightWay.corners = CornerCutting::Never;
+            gridOptimal.assign(queries.size(), -1);
+            for (std::size_t i = 0; i < queries.size(); ++i) {
+                const SearchResult truth = dijkstra(grid, queries[i].start, queries[i].target, nullptr, eightWay);
+                if (truth.found) gridOptimal[i] = truth.pathCost;
+            }
+        }
+        return gridOptimal;
+    };
+
+    for (const std::string &key : opt.algos) {
+        const AlgorithmEntry *entry = findAlgorithm(key);
+        if (!entry) { std::cerr << "unknown algorithm: " << key << '\n'; return 2; }
+        if (opt.connectivity == Connectivity::Eight && !supportsEightConnectivity(entry->algo)
+            && !isAnyAngle(entry->algo)) {
+            std::cerr << "skipping " << key << ": 4-connected only\n";
+            continue;
+        }
+
+        const bool anyAngle = isAnyAngle(entry->algo);
+        const std::vector<int> &truth = anyAngle ? anyAngleOptimal() : optimal;
+        for (const std::string &queueKey : opt.queues) {
+            const QueueEntry *queue = findQueue(queueKey);
+            if (!queue) { std::cerr << "unknown open list: " << queueKey << '\n'; return 2; }
+            SearchOptions options = movement;
+            options.queue = queue->kind;
+            options.threads = opt.threads;
+            options.counters = opt.counters;
+
+            Report report;
+            report.algo = entry->key;
+            report.queue = usesOpenList(entry->algo) ? queue->key : anyAngle ? "binary" : "fifo";
+            if (anyAngle) report.maxCostRatio = 0.0; // every path is compared, usually below 1
+            // A fresh context per report, so its size reflects this algorithm alone
+            SearchContext context;
+            std::vector<double> latencies;
+            double expanded = 0.0, generated = 0.0;
+            for (int rep = 0; rep < opt.repeat; ++rep) {
+                // --batch: all queries at once on the pool; latencies are the per-query search times
+                std::vector<SearchResult> batchResults;
+                if (batch) {
+                    batchResults = batch->run(grid, queries, entry->algo, options);
+                    report.totalMs += batch->lastStats().elapsedMs;
+                }
+                for (std::size_t i = 0; i < queries.size(); ++i) {
+                    SearchResult result;
+                    double ms;
+                    if (batch) {
+                        result = std::move(batchResults[i]);
+                        ms = result.stats.elapsedMs;
+                    } else {
+                        const auto t0 = std::chrono::steady_clock::now();
+                        result = runSearch(entry->algo, grid, queries[i].start, queries[i].target, context, nullptr, options);
+                        ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+                        report.totalMs += ms;
+                    }
+
+                    latencies.push_back(ms);
+                    ++report.queries;
+                    expanded += double(result.stats.nodesExpanded);
+                    generated += double(result.stats.nodesGenerated);
+                    const SearchCounters &counters = result.stats.counters;
+                    report.meanPushes += double(counters.pushes);
+                    report.meanPops += double(counters.pops);
+                    report.meanStalePops += double(counters.stalePops);
+                    report.peakOpen = std::max(report.peakOpen, counters.peakOpen);
+                    report.bytesAllocated += counters.bytesAllocated;
+                    report.pathMs += counters.pathMs;
+                    if (result.found) {
+                        ++report.solved;
+                        const bool worse = anyAngle ? result.pathCost > truth[i] : result.pathCost != truth[i];
+                        if (truth[i] > 0 && worse) ++report.suboptimal;
+                        if (truth[i] > 0 && (worse || anyAngle)) {
+                            const double ratio = double(result.pathCost) / truth[i];
+                            report.maxCostRatio = std::max(report.maxCostRatio, ratio);
+                        }
+                    } else if (truth[i] >= 0) {
+                        ++report.suboptimal; // missed a path that exists
+                    }
+                }
+            }
+            std::sort(latencies.begin(), latencies.end());
+            report.p50 = percentile(latencies, 0.50);
+            report.p90 = percentile(latencies, 0.90);
+            report.p99 = percentile(latencies, 0.99);
+            report.maxMs = latencies.back();
+            report.meanExpanded = expanded / report.queries;
+            report.meanGenerated = generated / report.queries;
+            report.meanPushes /= report.queries;
+            report.meanPops /= report.queries;
+            report.meanStalePops /= report.queries;
+            report.peakRssMb = peakRssMb();
+            if (usesContext(entry->algo))
+                report.scratchBytesPerCell = batch
+                    ? double(batch->memoryBytes()) / batch->threads() / grid.size()
+                    : double(context.memoryBytes()) / grid.size();
+            reports.push_back(report);
+
+            if (!usesOpenList(entry->algo)) break;
+        }
+    }
+
+    std::ofstream file;
+    if (!opt.output.empty()) {
+        file.open(opt.output);
+        if (!file) { std::cerr << "cannot write " << opt.output << '\n'; return 1; }
+    }
+    std::ostream &out = opt.output.empty() ? std::cout : file;
+    if (opt.format == "json") writeJson(out, opt, mapName, reports);
+    else writeCsv(out, opt, mapName, reports);
+    return 0;
+}
@@ -1,34 +1,124 @@
 #pragma once
 
+#include "Core/BatchSearch.hpp"
+#include "Core/ComponentMap.hpp"
+#include "Core/DStarLite.hpp"
+#include "Core/FlowField.hpp"
+#include "Core/GridMap.hpp"
+#include "Core/HierarchicalGraph.hpp"
+#include "Core/RunControl.hpp"
+#include "Core/Search.hpp"
+#include "Core/SearchTrace.hpp"
+
+#include <QMetaType>
 #include <QObject>
 #include <QPoint>
 #include <QVector>
 
+#include <atomic>
+#include <memory>
+
+Q_DECLARE_METATYPE(pathfinding::GridMap)
+Q_DECLARE_METATYPE(pathfinding::SearchOptions)
+
+// A finished run's trace, shared read-only between the worker and the GUI's player
+using SearchTracePtr = std::shared_ptr<const pathfinding::SearchTrace>;
+Q_DECLARE_METATYPE(SearchTracePtr)
+
+// One map snapshot shared read-only by several workers, so a race copies it once
+using GridMapPtr = std::shared_ptr<const pathfinding::GridMap>;
+Q_DECLARE_METATYPE(GridMapPtr)
+
+/**
+ * AlgorithmWorker is a thin Qt adapter over the headless pathfinding core.
+ * It lives on a worker thread and runs every search at full speed into a
+ * SearchTrace; the GUI replays the trace, so animation speed never slows
+ * the search down.
+ *
+ * Every request carries a run id issued by the GUI in increasing order, and
+ * every signal carries the id of the run that produced it, so the GUI can
+ * drop signals still in flight from a run it has moved past. cancelRuns() is
+ * thread-safe and called directly from the GUI thread rather than queued
+ * behind the run it cancels.
+ */
 class AlgorithmWorker : public QObject {
     Q_OBJECT
 public:
     explicit AlgorithmWorker(QObject *parent = nullptr);
     ~AlgorithmWorker() override;
 
+    // Stops run upToRun and every earlier one, running or still queued, within one expansion
+    void cancelRuns(quint64 upToRun);
+    // Cells run runId has expanded so far (0 before it starts); thread-safe, for live progress
+    qint64 expandedSoFar(quint64 runId) const {
+        return m_progressRun.load(std::memory_order_acquire) == runId ? m_expanded.load(std::memory_order_relaxed) : 0;
+    }
+
 public slots:
-    void runBFS(const QVector<QVector<int>> &grid, const QPoint &start, const QPoint &target, int delayMs);
-    void runDijkstra(const QVector<QVector<int>> &grid, const QPoint &start, const QPoint &target, int delayMs);
-    void runAStar(const QVector<QVector<int>> &grid, const QPoint &start, const QPoint &target, int delayMs);
+    // algorithm is a pathfinding::Algorithm value (plain int so it queues without a metatype)
+    void runSearch(quint64 runId, int algorithm, const pathfinding::GridMap &grid, const QPoint &start,
+                   const QPoint &target);
+    // Same over a snapshot other workers may be searching at the same time
+    void runSharedSearch(quint64 runId, int algorithm, const GridMapPtr &grid, const QPoint &start,
+                         const QPoint &target);
+    void runBFS(quint64 runId, const pathfinding::GridMap &grid, const QPoint &start, const QPoint &target);
+    void runDijkstra(quint64 runId, const pathfinding::GridMap &grid, const QPoint &start, const QPoint &target);
+    void runAStar(quint64 runId, const pathfinding::GridMap &grid, const QPoint &start, const QPoint &target);
+    // Incremental D* Lite replan after an edit
+    void replan(quint64 runId, const pathfinding::GridMap &grid, const QPoint &start, const QPoint &target);
+    // Solves count random start/target pairs over the free cells at once and draws every path
+    void runBatch(quint64 runId, int algorithm, const pathfinding::GridMap &grid, int count);
+    // Brings the region labels up to date with grid and sends them for the overlay
+    void showComponents(quint64 runId, const pathfinding::GridMap &grid);
 
-    void requestAbort();
+    // Applies to every following run (open-list choice, hot-path counters etc.)
+    void setSearchOptions(const pathfinding::SearchOptions &options);
 
 signals:
-    void visit(int row, int col);
-    void pathNode(int row, int col);
-    void status(const QString &msg);
-    void finished();
+    // Expansions and path of a finished search, sent once before its stats
+    void traceRecorded(quint64 runId, const SearchTracePtr &trace);
+    // Every path of a batch as flat cell indices (row * cols + col)
+    void pathBatch(quint64 runId, const QVector<int> &cells);
+    void searchStats(quint64 runId, qint64 nodesExpanded, double elapsedMs);
+    // Scratch memory the worker's search context holds after a BFS, Dijkstra or A* run
+    void scratchMemory(quint64 runId, qint64 bytes, int cells);
+    // Cost-to-target of every cell after a flow-field run (Unreachable = -1)
+    void distanceField(quint64 runId, const QVector<int> &dist);
+    // Region id of every cell (-1 = wall) for the components overlay
+    void componentLabels(quint64 runId, const QVector<int> &labels);
+    void status(quint64 runId, const QString &msg);
+    // Sent once per search, batch or replan request, also when it was cancelled before it started
+    void finished(quint64 runId);
 
 private:
-    volatile bool m_abortRequested;
+    friend class WorkerObserver;
+    friend class ProgressRecorder;
 
-    void sleepMs(int ms) const;
+    // Id of the request being served (worker thread only); stamped on every signal
+    quint64 m_runId = 0;
+    pathfinding::RunControl m_control;
+    pathfinding::SearchOptions m_options;
+    // Live progress of the search being recorded: its run id and expansions so far
+    std::atomic<quint64> m_progressRun{0};
+    std::atomic<qint64> m_expanded{0};
+    // Kept between runs; repaired incrementally when only a few cells changed
+    pathfinding::FlowField m_flowField;
+    pathfinding::DStarLite m_planner;
+    pathfinding::HierarchicalGraph m_hierarchy;
+    // Reused by every BFS, Dijkstra and A* run; resetting it is O(1)
+    pathfinding::SearchContext m_context;
+    // Created on the first batch; its pool threads and search contexts are reused afterwards
+    std::unique_ptr<pathfinding::BatchSearch> m_batch;
+    int m_batchThreads = 0;
 
-    static inline int manhattan(int r1, int c1, int r2, int c2) {
-        return qAbs(r1 - r2) + qAbs(c1 - c2);
-    }
+    // Starts serving runId; false (after reporting it) if the run was cancelled while queued
+    bool beginRun(quint64 runId);
+    void runAlgorithm(pathfinding::Algorithm algo, const pathfinding::GridMap &grid,
+                      const QPoint &start, const QPoint &target);
+    pathfinding::SearchResult runFlowField(const pathfinding::GridMap &grid, int start, int target,
+                                           pathfinding::SearchObserver *observer);
+    pathfinding::SearchResult runDStarLite(const pathfinding::GridMap &grid, int start, int target,
+                                           pathfinding::SearchObserver *observer);
+    pathfinding::SearchResult runHierarchical(const pathfinding::GridMap &grid, int start, int target,
+                                              pathfinding::SearchObserver *observer);
 };
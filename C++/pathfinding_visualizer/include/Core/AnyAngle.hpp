@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Core/Search.hpp"
+
+namespace pathfinding {
+
+/**
+ * Any-angle searches: a cell's parent may be any cell it can see (see
+ * LineOfSight), so the path is a polyline between cell centers instead of a
+ * chain of grid steps. result.path holds only the polyline's corners, start
+ * and target included, and pathCost is its Euclidean length in
+ * 1/StraightStep cell units, comparable with the 8-connected searches.
+ * Neighbors are 8-connected without corner cutting; the heuristic is the
+ * straight-line distance. Paths are short but not guaranteed optimal.
+ *
+ * Varying cell costs have no straight-line length, so on such maps both
+ * fall back to 8-connected aStar() and return its full cell path.
+ * options.queue is ignored: f values are not monotone here, so the searches
+ * always use a binary heap.
+ */
+
+// Theta*: checks line of sight from the current cell's parent to every new neighbor
+SearchResult thetaStar(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                       const SearchOptions &options = SearchOptions());
+SearchResult thetaStar(const GridMap &grid, int start, int target, SearchContext &context,
+                       SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+// Lazy Theta*: assumes line of sight when a cell is generated and checks it once, on expansion
+SearchResult lazyThetaStar(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                           const SearchOptions &options = SearchOptions());
+SearchResult lazyThetaStar(const GridMap &grid, int start, int target, SearchContext &context,
+                           SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+} // namespace pathfinding
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Core/ComponentMap.hpp"
+#include "Core/Search.hpp"
+#include "Core/SearchContext.hpp"
+#include "Core/ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+struct BatchQuery {
+    int start;
+    int target;
+};
+
+struct BatchStats {
+    int queries = 0;
+    int solved = 0;
+    int threads = 0;
+    std::int64_t nodesExpanded = 0;
+    bool aborted = false;
+    double elapsedMs = 0.0; // wall clock of the whole batch
+};
+
+/**
+ * Solves many (start, target) pairs over one shared, read-only map. Queries
+ * are spread over a work-stealing ThreadPool, and each worker runs them
+ * with its own SearchContext, which survives between batches, so after
+ * the first batch on a map the searches allocate nothing but their paths.
+ * The flow field, D* Lite and HPA* take no context: they reuse the
+ * structure each pool thread keeps for them, and the first two start over
+ * for every new target.
+ *
+ * The map's regions are labeled once per batch on the calling thread and
+ * pairs in different regions are answered without a search.
+ *
+ * Results come back in query order with the usual per-query stats.
+ * The grid must not change while run() is executing.
+ */
+class BatchSearch {
+public:
+    // threads <= 0 uses every hardware thread (the caller counts as one)
+    explicit BatchSearch(int threads = 0);
+
+    // observer is only polled through shouldAbort(), from every pool thread; once it returns true the
+    // running searches stop and the rest come back aborted
+    std::vector<SearchResult> run(const GridMap &grid, const std::vector<BatchQuery> &queries, Algorithm algo,
+                                  const SearchOptions &options = SearchOptions(), SearchObserver *observer = nullptr);
+
+    int threads() const { return m_pool.size(); }
+    const BatchStats &lastStats() const { return m_stats; }
+    // Scratch memory held by all workers' contexts and the region labels
+    std::size_t memoryBytes() const;
+
+private:
+    ThreadPool m_pool;
+    std::vector<SearchContext> m_contexts; // per worker
+    ComponentMap m_components;             // shared, read-only while the batch runs
+    BatchStats m_stats;
+};
+
+} // namespace pathfinding
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Core/Search.hpp"
+
+namespace pathfinding {
+
+/**
+ * Bidirectional searches grow one frontier from start and one from target
+ * and stop once no unexplored path can beat the best meeting found so far.
+ * Cells expanded from the target side are reported through
+ * SearchObserver::onVisitBackward().
+ *
+ * The start side runs on context and the target side on context.backward(),
+ * so a reused context makes both allocation-free; the overloads without a
+ * context use the calling thread's.
+ */
+
+// Expands whole BFS levels, always on the side with the smaller frontier.
+// Returns a path with the fewest steps, like bfs().
+SearchResult bidirectionalBfs(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                              const SearchOptions &options = SearchOptions());
+SearchResult bidirectionalBfs(const GridMap &grid, int start, int target, SearchContext &context,
+                              SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+// A* from both ends with each side aiming at the other's origin. Honours
+// cell costs; stops when the smallest f on either side reaches the best
+// meeting cost, which keeps the result optimal with consistent heuristics.
+SearchResult bidirectionalAStar(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                                const SearchOptions &options = SearchOptions());
+SearchResult bidirectionalAStar(const GridMap &grid, int start, int target, SearchContext &context,
+                                SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+} // namespace pathfinding
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Core/BitOps.hpp"
+#include "Core/GridMap.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * BitGrid is a bit-packed copy of a GridMap's walls, 64 cells per word,
+ * with bit = 1 meaning blocked. Every row has one word of blocked padding on
+ * the left and two on the right, and rows outside the grid read as blocked,
+ * so 64-cell windows can be read at any column without bounds checks.
+ *
+ * A mirrored copy (columns reversed) makes westward scans use the same
+ * low-bit-first window as eastward ones.
+ *
+ * On top of the windows it answers row scans a word at a time: free-run
+ * lengths and free-cell counts with bit scans and popcounts, and a scanline
+ * flood fill that claims whole runs of cells per step.
+ */
+class BitGrid {
+public:
+    // A horizontal run of cells (row, first..last)
+    struct Run {
+        int row;
+        int first;
+        int last;
+    };
+
+    BitGrid() = default;
+    explicit BitGrid(const GridMap &grid);
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    // Heap memory held by both bit planes
+    std::size_t memoryBytes() const { return (m_bits.capacity() + m_mirrored.capacity()) * sizeof(std::uint64_t); }
+
+    bool blocked(int r, int c) const {
+        if (r < 0 || r >= m_rows) return true;
+        const std::size_t bit = std::size_t(c + 64);
+        return (row(r)[bit >> 6] >> (bit & 63)) & 1u;
+    }
+
+    // Bit i = cell (r, c + i) is blocked, for c in [-64, cols + 64)
+    std::uint64_t windowEast(int r, int c) const { return window(m_bits, r, c); }
+    // Bit i = cell (r, c - i) is blocked
+    std::uint64_t windowWest(int r, int c) const { return window(m_mirrored, r, m_cols - 1 - c); }
+
+    // True if any of the cells (r, c0..c1) is blocked, tested 64 at a time; c0 >= -64, c1 < cols + 64
+    bool anyBlocked(int r, int c0, int c1) const {
+        for (int c = c0; c <= c1; c += 64) {
+            const int count = c1 - c + 1;
+            const std::uint64_t mask = count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+            if (windowEast(r, c) & mask) return true;
+        }
+        return false;
+    }
+
+    // Free cells among (r, c0..c1)
+    int freeCount(int r, int c0, int c1) const {
+        int free = 0;
+        for (int c = c0; c <= c1; c += 64) {
+            const int count = c1 - c + 1;
+            const std::uint64_t mask = count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+            free += popcount64(~windowEast(r, c) & mask);
+        }
+        return free;
+    }
+
+    // Free cells from (r, c) eastwards / westwards before the first blocked one (0 if (r, c) is blocked);
+    // the blocked padding ends every scan
+    int freeRunEast(int r, int c) const {
+        for (int n = 0;; n += 64)
+            if (const std::uint64_t w = windowEast(r, c + n)) return n + countTrailingZeros64(w);
+    }
+    int freeRunWest(int r, int c) const {
+        for (int n = 0;; n += 64)
+            if (const std::uint64_t w = windowWest(r, c - n)) return n + countTrailingZeros64(w);
+    }
+
+    /**
+     * 4-connected flood fill from (r, c): appends every free run of the
+     * region to runs and returns its cell count (0 if (r, c) is blocked).
+     * Each step takes a whole run, then seeds the rows above and below with
+     * one cell per free, unvisited stretch found by masking words.
+     */
+    std::int64_t floodFill(int r, int c, std::vector<Run> &runs) const;
+
+private:
+    const std::uint64_t *row(int r) const { return m_bits.data() + std::size_t(r) * m_stride; }
+
+    std::uint64_t window(const std::vector<std::uint64_t> &bits, int r, int c) const {
+        if (r < 0 || r >= m_rows) return ~std::uint64_t(0);
+        const std::uint64_t *words = bits.data() + std::size_t(r) * m_stride;
+        const std::size_t bit = std::size_t(c + 64);
+        const std::size_t w = bit >> 6;
+        const unsigned shift = unsigned(bit & 63);
+        if (shift == 0) return words[w];
+        return (words[w] >> shift) | (words[w + 1] << (64 - shift));
+    }
+
+    int m_rows = 0;
+    int m_cols = 0;
+    std::size_t m_stride = 0; // words per row, including padding
+    std::vector<std::uint64_t> m_bits;
+    std::vector<std::uint64_t> m_mirrored;
+};
+
+} // namespace pathfinding
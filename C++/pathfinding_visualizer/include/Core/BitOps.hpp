@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace pathfinding {
+
+// Number of bits needed to represent x (0 for x == 0)
+inline int bitWidth32(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? 32 - __builtin_clz(x) : 0;
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    return _BitScanReverse(&idx, x) ? int(idx) + 1 : 0;
+#else
+    int bits = 0;
+    while (x) { ++bits; x >>= 1; }
+    return bits;
+#endif
+}
+
+// Index of the lowest set bit; x must be non-zero
+inline int countTrailingZeros64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return int(idx);
+#else
+    int n = 0;
+    while (!(x & 1u)) { ++n; x >>= 1; }
+    return n;
+#endif
+}
+
+// Bit i moves to bit 63 - i
+inline std::uint64_t reverseBits64(std::uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+    x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(x);
+#else
+    x = ((x >> 8) & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+    return (x >> 32) | (x << 32);
+#endif
+}
+
+inline int popcount64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return int(__popcnt64(x));
+#else
+    int n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+
+} // namespace pathfinding
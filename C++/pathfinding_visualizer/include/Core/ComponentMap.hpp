@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Core/MapSnapshot.hpp"
+#include "Core/Search.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * ComponentMap labels the connected regions of free cells, so "is target
+ * reachable from start" is two array reads instead of a search that floods
+ * the start's whole region before giving up.
+ *
+ * Regions are 4-connected. With diagonal set, cells that only touch at a
+ * corner are joined too, which matches 8-connected movement that may squeeze
+ * between two walls; the stricter corner rules never leave the 4-connected
+ * regions, so they use the plain labels.
+ *
+ * build is a two-pass union-find over the free runs of each row (found 64
+ * cells at a time from the packed walls). update() diffs against the
+ * snapshot of the last build: freed cells are unioned with their neighbors,
+ * and a new wall relabels its region only if the free cells around it are
+ * not connected to each other through its ring of eight neighbors, the only
+ * case in which it can split the region.
+ */
+class ComponentMap {
+public:
+    struct UpdateStats {
+        bool incremental = false;
+        std::int64_t cellsChanged = 0;   // wall toggles applied
+        std::int64_t cellsRelabeled = 0; // cells visited to split regions
+        bool aborted = false;            // the map is left empty
+        double elapsedMs = 0.0;
+    };
+
+    // observer is only polled through shouldAbort(), once per row or per 4096 relabeled cells
+    const UpdateStats &update(const GridMap &grid, bool diagonal = false, SearchObserver *observer = nullptr);
+    void clear();
+
+    bool empty() const { return m_label.empty(); }
+    bool diagonal() const { return m_diagonal; }
+    std::uint64_t version() const { return m_snapshot.version(); }
+    int componentCount() const { return m_componentCount; }
+    const UpdateStats &lastUpdate() const { return m_lastUpdate; }
+    std::size_t memoryBytes() const;
+
+    // Region id of cell, -1 for walls; ids are only stable until the next update
+    int component(int cell) const {
+        const int label = m_label[std::size_t(cell)];
+        return label < 0 ? -1 : m_root[std::size_t(label)];
+    }
+    // False only if no search can get from start to target; a wall start may still be left
+    bool reachable(int start, int target) const;
+
+private:
+    // Both return false when aborted or, for repair(), when relabeling would cost more than a rebuild
+    bool build(const GridMap &grid, SearchObserver *observer);
+    bool repair(const GridMap &grid, const std::vector<int> &changed, SearchObserver *observer);
+    int newLabel();
+    int find(int label);
+    // Separate groups the free cells of cell's ring form, counting those cell is linked to
+    template <typename Blocked>
+    int ringGroups(int cell, Blocked &&blocked) const;
+    /**
+     * Labels every free cell linked to seed whose label predates firstNew and
+     * returns the cells labeled, or -1 once that would exceed budget or observer aborts.
+     */
+    std::int64_t relabel(const GridMap &grid, int seed, int label, int firstNew, std::int64_t budget,
+                         std::vector<int> &deadRoots, SearchObserver *observer);
+
+    // Calls fn(neighbor) for the in-bounds cells that share an edge (or a corner, when diagonal) with cell
+    template <typename Fn>
+    void forEachLinked(int cell, Fn &&fn) const {
+        const int r = cell / m_cols, c = cell - r * m_cols;
+        const int r0 = r > 0 ? r - 1 : r, r1 = r + 1 < m_rows ? r + 1 : r;
+        const int c0 = c > 0 ? c - 1 : c, c1 = c + 1 < m_cols ? c + 1 : c;
+        for (int rr = r0; rr <= r1; ++rr)
+            for (int cc = c0; cc <= c1; ++cc)
+                if ((rr != r || cc != c) && (m_diagonal || rr == r || cc == c)) fn(rr * m_cols + cc);
+    }
+
+    int m_rows = 0;
+    int m_cols = 0;
+    bool m_diagonal = false;
+    int m_componentCount = 0;
+    std::vector<int> m_label; // per cell, -1 = wall
+    std::vector<int> m_root;  // union-find parent per label; flattened after every update
+    MapSnapshot m_snapshot;
+    UpdateStats m_lastUpdate;
+};
+
+// This thread's ComponentMap for the movement of options, brought up to date with grid (empty if aborted)
+const ComponentMap &componentsFor(const GridMap &grid, const SearchOptions &options,
+                                  SearchObserver *observer = nullptr);
+
+} // namespace pathfinding
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Core/MapSnapshot.hpp"
+#include "Core/Search.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * D* Lite (Koenig & Likhachev): an incremental A* that searches backward
+ * from the target and keeps its g/rhs values and open list between plans.
+ *
+ * plan() diffs the map against the snapshot of the previous plan. Only the
+ * cells whose incoming edges changed are re-evaluated, and the search then
+ * re-expands just the region whose costs actually moved, instead of the
+ * whole map. The start may move between plans (the key modifier km keeps
+ * the queue valid); a new target, new dimensions, a large edit or a cheaper
+ * cost minimum (the heuristic scale) start over.
+ */
+class DStarLite {
+public:
+    struct PlanStats {
+        bool incremental = false;
+        bool aborted = false;           // the plan resumes from here on the next call
+        std::int64_t cellsChanged = 0;  // map cells that differed from the snapshot
+        std::int64_t expanded = 0;      // cells popped from the open list by this plan
+        double pathMs = 0.0;            // following g down to the goal, included in elapsedMs
+        double elapsedMs = 0.0;
+    };
+
+    // Reports each expanded cell through observer->onVisit(), if given
+    SearchResult plan(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr);
+    void clear();
+
+    bool valid() const { return m_goal >= 0; }
+    int target() const { return m_goal; }
+    const PlanStats &lastPlan() const { return m_lastPlan; }
+
+private:
+    struct Key {
+        int k1;
+        int k2;
+        bool operator<(const Key &o) const { return k1 < o.k1 || (k1 == o.k1 && k2 < o.k2); }
+        bool operator==(const Key &o) const { return k1 == o.k1 && k2 == o.k2; }
+    };
+    struct Entry {
+        Key key;
+        int cell;
+    };
+
+    void initialize(const GridMap &grid, int start, int target);
+    Key calculateKey(int cell) const;
+    int heuristic(int a, int b) const;
+    int lookahead(const GridMap &grid, int cell) const;
+    void updateVertex(const GridMap &grid, int cell);
+    void push(int cell, Key key);
+    bool topKey(Key &key);
+    void computeShortestPath(const GridMap &grid, SearchObserver *observer);
+    bool extractPath(const GridMap &grid, std::vector<int> &path) const;
+
+    int m_goal = -1;
+    int m_start = -1;
+    int m_last = -1;               // start when km was last updated
+    int m_km = 0;
+    int m_hScale = 1;              // map minCost() at initialization
+    std::vector<int> m_g;
+    std::vector<int> m_rhs;
+    std::vector<Key> m_key;        // key of each cell's live open-list entry
+    std::vector<std::uint8_t> m_open;
+    std::vector<Entry> m_heap;     // min-heap with lazy deletion
+    MapSnapshot m_snapshot;
+    PlanStats m_lastPlan;
+};
+
+/**
+ * Point-to-point form for runSearch(): keeps one planner per thread, so
+ * repeated queries to the same target only repair what changed.
+ */
+SearchResult dStarLiteSearch(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                             const SearchOptions &options = SearchOptions());
+
+} // namespace pathfinding
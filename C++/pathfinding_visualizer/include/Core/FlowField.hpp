@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Core/MapSnapshot.hpp"
+#include "Core/Search.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * FlowField is a reverse Dijkstra from one target: the cost from every cell
+ * to the target plus the neighbor to step to next. Once built, a query from
+ * any start just follows next() in O(path length), which is what many agents
+ * heading for the same target need.
+ *
+ * update() keeps the field in step with the map. It returns immediately for
+ * the version the field was built from; otherwise it diffs the new map
+ * against its own snapshot. Cells whose route ran through a cell that got
+ * more expensive or became a wall are invalidated, and only those plus the
+ * cells that can now do better are recomputed. A new target, new
+ * dimensions or a large edit rebuild from scratch.
+ */
+class FlowField {
+public:
+    struct UpdateStats {
+        bool incremental = false;
+        bool aborted = false;             // observer asked to stop; the field was cleared
+        std::int64_t cellsChanged = 0;    // map cells that differed from the snapshot
+        std::int64_t cellsRecomputed = 0; // cells settled by the (partial) Dijkstra
+        double elapsedMs = 0.0;
+    };
+
+    // Reports each settled cell through observer->onVisit(), if given
+    const UpdateStats &update(const GridMap &grid, int target, SearchObserver *observer = nullptr);
+    void clear();
+
+    bool valid() const { return m_target >= 0; }
+    int target() const { return m_target; }
+    std::uint64_t version() const { return m_snapshot.version(); }
+    const UpdateStats &lastUpdate() const { return m_lastUpdate; }
+
+    // Cost of the cells entered on the way from cell to target, or Unreachable (-1)
+    int distance(int cell) const;
+    // Neighbor one step closer to target (-1 at target or where unreachable)
+    int next(int cell) const { return m_next[std::size_t(cell)]; }
+    // Largest finite distance, for colouring
+    int maxDistance() const;
+
+    // Follows the field from start; stats report the steps taken
+    SearchResult query(int start) const;
+
+private:
+    void rebuild(const GridMap &grid, int target, SearchObserver *observer);
+    void repair(const GridMap &grid, const std::vector<int> &changed, SearchObserver *observer);
+
+    int m_target = -1;
+    std::vector<int> m_dist;  // INF where unreachable
+    std::vector<int> m_next;
+    MapSnapshot m_snapshot;   // map the field was computed for
+    UpdateStats m_lastUpdate;
+};
+
+/**
+ * Point-to-point form for runSearch(): keeps one FlowField per thread and
+ * reuses it while the target and map stay the same.
+ */
+SearchResult flowFieldSearch(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                             const SearchOptions &options = SearchOptions());
+
+} // namespace pathfinding
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * GridMap is a row-major grid whose walls are packed one bit per cell:
+ * bit i of the wall words is cell i, for flat index i = row * cols + col, so
+ * isWall() is a shift and a mask and a 100M-cell map needs 12.5 MB.
+ * Cells are addressed either by (row, col) or by a flat index.
+ *
+ * Traversal costs (1-255, the cost of entering a cell) live in a second
+ * uint8 layer that is only allocated once a non-unit cost is set, so
+ * uniform-cost maps pay nothing for it.
+ *
+ * It has no Qt dependency so it can be used from batch tools, and it is a
+ * plain value type that is cheap to copy across threads.
+ *
+ * version() identifies the contents: copies share it and every modification
+ * changes it, so caches built from a map can tell when they are stale.
+ * Modifications draw the new id, so version() only reads and one const map
+ * can be searched from several threads at once.
+ */
+class GridMap {
+public:
+    static constexpr std::uint8_t Free = 0;
+    static constexpr std::uint8_t Wall = 1;
+    static constexpr std::uint8_t UnitCost = 1;
+    static constexpr std::uint8_t MaxCost = 255;
+    // Flat indices are ints, so rows * cols may not exceed this
+    static constexpr std::int64_t MaxCells = std::numeric_limits<int>::max();
+
+    GridMap() = default;
+    GridMap(int rows, int cols, std::uint8_t fill = Free);
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    int size() const { return m_rows * m_cols; }
+    bool empty() const { return size() == 0; }
+
+    bool inBounds(int r, int c) const { return r >= 0 && r < m_rows && c >= 0 && c < m_cols; }
+    int index(int r, int c) const { return r * m_cols + c; }
+    int rowOf(int idx) const { return idx / m_cols; }
+    int colOf(int idx) const { return idx % m_cols; }
+
+    std::uint8_t cell(int idx) const { return isWall(idx) ? Wall : Free; }
+    bool isWall(int idx) const { return (m_walls[std::size_t(idx) >> 6] >> (idx & 63)) & 1u; }
+    bool isWall(int r, int c) const { return isWall(index(r, c)); }
+
+    // Any value other than Free is a wall
+    void setCell(int idx, std::uint8_t value) { setBit(idx, value != Free); touch(); }
+    void setWall(int r, int c, bool wall) { setBit(index(r, c), wall); touch(); }
+    void fill(std::uint8_t value);
+
+    // Packed walls, bit i = cell i; bits past size() are always 0
+    const std::uint64_t *wallWords() const { return m_walls.data(); }
+    std::size_t wallWordCount() const { return m_walls.size(); }
+    // Walls of the 64 cells from flat index idx on (bit j = cell idx + j); cells past the end read as walls
+    std::uint64_t wallWindow(int idx) const;
+    // Sets the walls of count (<= 64) cells from idx on to the low bits of bits
+    void setWalls(int idx, std::uint64_t bits, int count);
+    std::int64_t wallCount() const;
+
+    // Process-wide unique id of the current contents (never 0)
+    std::uint64_t version() const { return m_version; }
+
+    // Traversal costs
+    bool hasCosts() const { return !m_costs.empty(); }
+    std::uint8_t cost(int idx) const { return m_costs.empty() ? UnitCost : m_costs[idx]; }
+    void setCost(int idx, std::uint8_t cost);
+    // Replaces the whole cost layer (size() bytes, 0 is read as 1)
+    void setCosts(const std::uint8_t *costs);
+    void clearCosts();
+    // Smallest cost of any cell; scales the A* heuristic so it stays admissible
+    int minCost() const;
+    int maxCost() const;
+    const std::uint8_t *costData() const { return m_costs.empty() ? nullptr : m_costs.data(); }
+
+private:
+    // Next id from a process-wide atomic counter
+    static std::uint64_t nextVersion();
+    void touch() { m_version = nextVersion(); }
+    void setBit(int idx, bool wall) {
+        const std::uint64_t bit = std::uint64_t(1) << (idx & 63);
+        std::uint64_t &word = m_walls[std::size_t(idx) >> 6];
+        word = wall ? word | bit : word & ~bit;
+    }
+
+    int m_rows = 0;
+    int m_cols = 0;
+    std::vector<std::uint64_t> m_walls;     // ceil(size / 64) words
+    std::vector<std::uint8_t> m_costs;      // empty = all UnitCost
+    std::vector<std::uint32_t> m_costCount; // histogram of m_costs, 256 buckets
+    std::uint64_t m_version = nextVersion();
+};
+
+} // namespace pathfinding
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Core/MapSnapshot.hpp"
+#include "Core/Search.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * HierarchicalGraph is the abstract graph of HPA* (Botea, Müller & Schaeffer).
+ * The grid is cut into square clusters. Every maximal run of open cell pairs
+ * across a cluster border becomes one entrance (two for runs of six or more,
+ * one at each end), and each cluster stores the in-cluster cost between all
+ * pairs of its entrance cells.
+ *
+ * query() connects start and target to the entrances of their clusters,
+ * runs A* over the small abstract graph and refines each abstract edge with
+ * a search confined to one cluster. Paths are usually within a few percent
+ * of optimal but not guaranteed optimal.
+ *
+ * update() diffs the map against the snapshot the graph was built from and
+ * rebuilds only the clusters that contain an edited cell, plus the neighbor
+ * across the border when the edited cell lies on one.
+ */
+class HierarchicalGraph {
+public:
+    static constexpr int DefaultClusterSize = 16;
+
+    struct UpdateStats {
+        bool incremental = false;
+        std::int64_t cellsChanged = 0;
+        int clustersRebuilt = 0;
+        bool aborted = false; // the graph is left empty
+        double elapsedMs = 0.0;
+    };
+
+    explicit HierarchicalGraph(int clusterSize = DefaultClusterSize);
+
+    // observer is only polled through shouldAbort(), once per cluster
+    const UpdateStats &update(const GridMap &grid, SearchObserver *observer = nullptr);
+    void clear();
+
+    // Brings the graph up to date with grid first; observer sees expanded abstract nodes
+    SearchResult query(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr);
+
+    bool valid() const { return !m_clusters.empty(); }
+    int clusterSize() const { return m_clusterSize; }
+    int clusterCount() const { return int(m_clusters.size()); }
+    int nodeCount() const { return m_nodeCount; }
+    const UpdateStats &lastUpdate() const { return m_lastUpdate; }
+    // Time the last query spent refining its abstract path into cells (its path reconstruction)
+    double lastRefineMs() const { return m_lastRefineMs; }
+
+private:
+    struct Transition {
+        int node; // local index of the entrance cell inside this cluster
+        int cell; // cell across the border, an entrance of the neighbor cluster
+    };
+    struct Cluster {
+        int r0 = 0, c0 = 0, r1 = 0, c1 = 0; // [r0, r1) x [c0, c1)
+        std::vector<int> nodes;             // entrance cells
+        std::vector<Transition> exits;
+        std::vector<int> dist;              // nodes x nodes, row = from; INF if not connected inside
+    };
+
+    int clusterOf(const GridMap &grid, int cell) const;
+    // False if observer aborted before every cluster was built
+    bool build(const GridMap &grid, SearchObserver *observer);
+    void buildCluster(const GridMap &grid, int index);
+    void addEntrances(const GridMap &grid, Cluster &cluster, int dr, int dc);
+    void renumber();
+    // Local index of cell among the entrances of its cluster, or -1
+    int localNode(const Cluster &cluster, int cell) const;
+
+    int m_clusterSize;
+    int m_clusterRows = 0;
+    int m_clusterCols = 0;
+    int m_nodeCount = 0;
+    std::vector<Cluster> m_clusters;
+    std::vector<int> m_firstNode;   // global id of each cluster's node 0
+    std::vector<int> m_nodeCell;    // by global id
+    std::vector<int> m_nodeCluster; // by global id
+    MapSnapshot m_snapshot;
+    UpdateStats m_lastUpdate;
+    double m_lastRefineMs = 0.0;
+};
+
+/**
+ * Point-to-point form for runSearch(): keeps one graph per thread and only
+ * rebuilds the clusters that changed since the previous query's map.
+ */
+SearchResult hpaSearch(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                       const SearchOptions &options = SearchOptions());
+
+} // namespace pathfinding
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Core/Search.hpp"
+
+namespace pathfinding {
+
+/**
+ * Jump Point Search for 4-connected grids with uniform cost. Straight runs
+ * are skipped in one "jump" that stops only at the target, at a cell with a
+ * forced neighbor, or (for vertical jumps) at a cell from which a horizontal
+ * jump would succeed; only those jump points enter the open list.
+ * The returned path is expanded back to every cell and is optimal.
+ *
+ * Maps with varying cell costs have no symmetric runs to prune, so both
+ * entry points fall back to aStar() on them. Scores and parents live in a
+ * SearchContext, as for A*; the overloads without one use the thread's.
+ */
+SearchResult jumpPointSearch(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                             const SearchOptions &options = SearchOptions());
+SearchResult jumpPointSearch(const GridMap &grid, int start, int target, SearchContext &context,
+                             SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+/**
+ * Same search, but horizontal jumps read the walls from a BitGrid 64 cells
+ * at a time and locate the stop cell with a bit scan instead of stepping
+ * cell by cell (block-based JPS). The BitGrid is kept per thread and only
+ * rebuilt when the map's version() changes.
+ */
+SearchResult blockJumpPointSearch(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                                  const SearchOptions &options = SearchOptions());
+SearchResult blockJumpPointSearch(const GridMap &grid, int start, int target, SearchContext &context,
+                                  SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+} // namespace pathfinding
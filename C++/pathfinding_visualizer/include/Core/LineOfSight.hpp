@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Core/BitGrid.hpp"
+#include "Core/GridMap.hpp"
+
+#include <cstdint>
+
+namespace pathfinding {
+
+/**
+ * Line-of-sight queries between cell centers for the any-angle searches.
+ * A segment is clear when every cell whose closed square it touches is free,
+ * so it may not pass exactly through a corner next to a wall (the same rule
+ * as 8-connected moves with CornerCutting::Never) and cells outside the grid
+ * count as walls.
+ *
+ * The segment is cut into one span of cells per row it crosses (per column
+ * for steep lines, on a transposed copy), and each span is tested against a
+ * BitGrid 64 cells per word; a line costs O(rows crossed) word reads rather
+ * than one read per cell.
+ */
+class LineOfSight {
+public:
+    LineOfSight() = default;
+    explicit LineOfSight(const GridMap &grid);
+
+    bool empty() const { return m_rows == 0; }
+    // GridMap::version() of the map the layers were built from
+    std::uint64_t version() const { return m_version; }
+
+    bool visible(int from, int to) const;
+
+private:
+    int m_rows = 0;
+    int m_cols = 0;
+    std::uint64_t m_version = 0;
+    BitGrid m_byRow;
+    BitGrid m_byCol; // transposed: row i holds column i
+};
+
+} // namespace pathfinding
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Core/GridMap.hpp"
+
+#include <string>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * One line of a MovingAI .scen file. Coordinates are x = column, y = row,
+ * as in the benchmark format.
+ */
+struct Scenario {
+    int bucket = 0;
+    std::string mapFile;
+    int mapWidth = 0;
+    int mapHeight = 0;
+    int startX = 0;
+    int startY = 0;
+    int goalX = 0;
+    int goalY = 0;
+    double optimalLength = 0.0;
+};
+
+/**
+ * MovingAI benchmark maps (https://movingai.com/benchmarks/formats.html).
+ * '.', 'G' and 'S' are loaded as free cells, every other terrain as walls.
+ * Saving writes '.' and '@'.
+ * Loading rejects headers of more than GridMap::MaxCells cells, and files
+ * too short for the rows their header announces, before allocating the grid.
+ */
+bool loadMovingAiMap(const std::string &path, GridMap &out, std::string *error = nullptr);
+bool saveMovingAiMap(const std::string &path, const GridMap &grid, std::string *error = nullptr);
+
+bool loadMovingAiScenarios(const std::string &path, std::vector<Scenario> &out, std::string *error = nullptr);
+bool saveMovingAiScenarios(const std::string &path, const std::vector<Scenario> &scenarios,
+                           std::string *error = nullptr);
+
+/**
+ * Compact binary map (".pfgm"), little-endian:
+ *   char magic[4] = "PFGM"; uint32 version; uint32 rows; uint32 cols;
+ *   rows * ceil(cols / 64) uint64 words, bit (c % 64) of word (c / 64) set = wall.
+ * Version 2 appends rows * cols uint8 cell costs; version 1 (unit costs) is
+ * written whenever the map has no cost layer.
+ * Loading memory-maps the file and unpacks 64 cells per word; maps of more
+ * than GridMap::MaxCells cells are rejected.
+ */
+bool loadBinaryMap(const std::string &path, GridMap &out, std::string *error = nullptr);
+bool saveBinaryMap(const std::string &path, const GridMap &grid, std::string *error = nullptr);
+
+// Picks the format from the extension: ".map" (MovingAI) or ".pfgm" (binary)
+bool loadMap(const std::string &path, GridMap &out, std::string *error = nullptr);
+bool saveMap(const std::string &path, const GridMap &grid, std::string *error = nullptr);
+
+} // namespace pathfinding
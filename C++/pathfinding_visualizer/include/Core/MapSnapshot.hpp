@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Core/GridMap.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * Copy of the walls and costs a cached search result was computed from.
+ * diff() lists what changed in a newer map of the same size, so incremental
+ * planners can repair instead of recomputing; apply() then brings the copy
+ * up to date without copying the whole map again.
+ */
+class MapSnapshot {
+public:
+    void assign(const GridMap &grid);
+    void clear();
+
+    bool empty() const { return m_rows == 0; }
+    bool sameShape(const GridMap &grid) const { return grid.rows() == m_rows && grid.cols() == m_cols; }
+    bool sameVersion(const GridMap &grid) const { return !empty() && grid.version() == m_version; }
+    std::uint64_t version() const { return m_version; }
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
+    std::uint8_t cell(int idx) const {
+        return (m_walls[std::size_t(idx) >> 6] >> (idx & 63)) & 1u ? GridMap::Wall : GridMap::Free;
+    }
+    std::uint8_t cost(int idx) const { return m_costs.empty() ? GridMap::UnitCost : m_costs[std::size_t(idx)]; }
+
+    /**
+     * Sorted indices of cells whose state or cost differs in grid (same shape).
+     * Returns false, with changed incomplete, once more than limit cells differ.
+     */
+    bool diff(const GridMap &grid, std::size_t limit, std::vector<int> &changed) const;
+    // Copies the listed cells from grid (the result of diff())
+    void apply(const GridMap &grid, const std::vector<int> &changed);
+
+private:
+    int m_rows = 0;
+    int m_cols = 0;
+    std::uint64_t m_version = 0;
+    std::vector<std::uint64_t> m_walls; // GridMap::wallWords() layout
+    std::vector<std::uint8_t> m_costs; // empty = all UnitCost
+};
+
+} // namespace pathfinding
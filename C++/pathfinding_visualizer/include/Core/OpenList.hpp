@@ -0,0 +1,226 @@
+#pragma once
+
+#include "Core/BitOps.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * Open-list (priority queue) implementations for the integer-cost searches.
+ * They are header-only so the search loops can inline push/pop.
+ *
+ * Common interface:
+ *   void push(int f, int h, int cell);  // f = priority, h = tie-breaker (smaller first)
+ *   OpenEntry pop();                    // entry with the smallest f
+ *   bool empty() const; std::size_t size() const; void clear();
+ *   std::size_t memoryBytes() const;     // heap memory held, by capacity
+ *
+ * Entries are never decreased in place: searches push duplicates and skip
+ * stale ones when popped (lazy deletion). The bucket queue and radix heap
+ * require monotone keys, which Dijkstra and A* with a consistent heuristic
+ * guarantee (a pushed f is never below the last popped f).
+ */
+enum class QueueKind {
+    BinaryHeap,
+    QuaternaryHeap,
+    BucketQueue,
+    RadixHeap
+};
+
+const char *queueKindName(QueueKind kind);
+
+struct OpenEntry {
+    int f;
+    int cell;
+};
+
+/**
+ * Implicit d-ary min-heap ordered by (f, h). D = 2 is a binary heap,
+ * D = 4 trades slightly more comparisons per level for half the depth
+ * and better cache locality on sift-down.
+ */
+template <int D>
+class DaryHeap {
+public:
+    void push(int f, int h, int cell) {
+        m_items.push_back({key(f, h), cell});
+        siftUp(m_items.size() - 1);
+    }
+
+    OpenEntry pop() {
+        const Item top = m_items.front();
+        m_items.front() = m_items.back();
+        m_items.pop_back();
+        if (!m_items.empty()) siftDown(0);
+        return {static_cast<int>(top.key >> 32), top.cell};
+    }
+
+    bool empty() const { return m_items.empty(); }
+    std::size_t size() const { return m_items.size(); }
+    void clear() { m_items.clear(); }
+    std::size_t memoryBytes() const { return m_items.capacity() * sizeof(Item); }
+
+private:
+    struct Item {
+        std::uint64_t key;
+        int cell;
+    };
+
+    static std::uint64_t key(int f, int h) {
+        return (std::uint64_t(std::uint32_t(f)) << 32) | std::uint32_t(h);
+    }
+
+    void siftUp(std::size_t i) {
+        const Item item = m_items[i];
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / D;
+            if (m_items[parent].key <= item.key) break;
+            m_items[i] = m_items[parent];
+            i = parent;
+        }
+        m_items[i] = item;
+    }
+
+    void siftDown(std::size_t i) {
+        const std::size_t n = m_items.size();
+        const Item item = m_items[i];
+        for (;;) {
+            const std::size_t first = i * D + 1;
+            if (first >= n) break;
+            std::size_t best = first;
+            const std::size_t last = first + D < n ? first + D : n;
+            for (std::size_t c = first + 1; c < last; ++c)
+                if (m_items[c].key < m_items[best].key) best = c;
+            if (item.key <= m_items[best].key) break;
+            m_items[i] = m_items[best];
+            i = best;
+        }
+        m_items[i] = item;
+    }
+
+    std::vector<Item> m_items;
+};
+
+using BinaryHeap = DaryHeap<2>;
+using QuaternaryHeap = DaryHeap<4>;
+
+/**
+ * Dial's bucket queue: a circular array of buckets indexed by f.
+ * All live keys must lie within [lastPopped, lastPopped + span), which holds
+ * when span exceeds the largest f increase along one edge. Push and pop are
+ * O(1) amortized. Within a bucket entries pop LIFO, which breaks f ties
+ * towards the most recently generated (deeper) cells.
+ */
+class BucketQueue {
+public:
+    explicit BucketQueue(int span = 256) {
+        std::size_t buckets = 1;
+        while (buckets < static_cast<std::size_t>(span > 1 ? span : 1)) buckets <<= 1;
+        m_buckets.resize(buckets);
+        m_mask = buckets - 1;
+    }
+
+    void push(int f, int h, int cell) {
+        (void)h;
+        // Keys never go below the last popped one, so lowering the cursor stays in the window
+        if (m_size == 0 || f < m_current) m_current = f;
+        m_buckets[std::size_t(f) & m_mask].push_back(cell);
+        ++m_size;
+    }
+
+    OpenEntry pop() {
+        std::vector<int> *bucket = &m_buckets[std::size_t(m_current) & m_mask];
+        while (bucket->empty()) {
+            ++m_current;
+            bucket = &m_buckets[std::size_t(m_current) & m_mask];
+        }
+        const int cell = bucket->back();
+        bucket->pop_back();
+        --m_size;
+        return {m_current, cell};
+    }
+
+    bool empty() const { return m_size == 0; }
+    std::size_t size() const { return m_size; }
+    void clear() {
+        for (auto &bucket : m_buckets) bucket.clear();
+        m_size = 0;
+        m_current = 0;
+    }
+    std::size_t memoryBytes() const {
+        std::size_t bytes = m_buckets.capacity() * sizeof(std::vector<int>);
+        for (const auto &bucket : m_buckets) bytes += bucket.capacity() * sizeof(int);
+        return bytes;
+    }
+
+private:
+    std::vector<std::vector<int>> m_buckets;
+    std::size_t m_mask = 0;
+    std::size_t m_size = 0;
+    int m_current = 0;
+};
+
+/**
+ * Radix heap for monotone integer keys: bucket i holds keys whose highest
+ * bit differing from the last popped key is bit i - 1. Pop only rescans the
+ * first non-empty bucket, so each entry moves at most 32 times in total.
+ */
+class RadixHeap {
+public:
+    void push(int f, int h, int cell) {
+        (void)h;
+        m_buckets[bucketIndex(std::uint32_t(f))].push_back({std::uint32_t(f), cell});
+        ++m_size;
+    }
+
+    OpenEntry pop() {
+        if (m_buckets[0].empty()) {
+            std::size_t i = 1;
+            while (m_buckets[i].empty()) ++i;
+            std::uint32_t minKey = m_buckets[i].front().key;
+            for (const Item &item : m_buckets[i])
+                if (item.key < minKey) minKey = item.key;
+            m_last = minKey;
+            for (const Item &item : m_buckets[i])
+                m_buckets[bucketIndex(item.key)].push_back(item);
+            m_buckets[i].clear();
+        }
+        const Item item = m_buckets[0].back();
+        m_buckets[0].pop_back();
+        --m_size;
+        return {int(item.key), item.cell};
+    }
+
+    bool empty() const { return m_size == 0; }
+    std::size_t size() const { return m_size; }
+    void clear() {
+        for (auto &bucket : m_buckets) bucket.clear();
+        m_size = 0;
+        m_last = 0;
+    }
+    std::size_t memoryBytes() const {
+        std::size_t bytes = 0;
+        for (const auto &bucket : m_buckets) bytes += bucket.capacity() * sizeof(Item);
+        return bytes;
+    }
+
+private:
+    struct Item {
+        std::uint32_t key;
+        int cell;
+    };
+
+    std::size_t bucketIndex(std::uint32_t key) const {
+        return static_cast<std::size_t>(bitWidth32(key ^ m_last));
+    }
+
+    std::vector<Item> m_buckets[33];
+    std::size_t m_size = 0;
+    std::uint32_t m_last = 0;
+};
+
+} // namespace pathfinding
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Core/Search.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+struct ParallelBfsOptions {
+    int threads = 0;                 // <= 0: all hardware threads
+    bool directionOptimizing = true; // allow bottom-up levels
+    int alpha = 14;                  // go bottom-up when frontier > unvisited / alpha
+    int beta = 24;                   // back to top-down when frontier < cells / beta
+};
+
+struct DistanceFieldStats {
+    int levels = 0;
+    int bottomUpLevels = 0;
+    std::int64_t cellsReached = 0;
+    std::int64_t widestLevel = 0; // cells in the largest frontier
+    double elapsedMs = 0.0;
+};
+
+/**
+ * Steps from source to every cell over 4-connected free cells
+ * (Unreachable where there is no path). Serial reference implementation.
+ */
+std::vector<int> bfsDistanceField(const GridMap &grid, int source);
+
+/**
+ * Level-synchronous BFS: each level's frontier is split into chunks across a
+ * ThreadPool and cells are claimed with an atomic visited bitmap. Large
+ * frontiers switch to bottom-up levels, where every unvisited cell looks for a
+ * parent in the current level instead (direction-optimizing BFS).
+ * The result is identical to bfsDistanceField().
+ */
+std::vector<int> parallelBfsDistanceField(const GridMap &grid, int source,
+                                          const ParallelBfsOptions &options = ParallelBfsOptions(),
+                                          DistanceFieldStats *stats = nullptr);
+
+/**
+ * Point-to-point query on top of the parallel field: stops after the level
+ * that reaches target and walks the distances back. Reports each level's
+ * cells through the observer between levels, from the calling thread.
+ * Uses options.threads. Distances are kept in context (the calling thread's
+ * without one) and the bitmaps per calling thread, both reused between queries.
+ */
+SearchResult parallelBfs(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                         const SearchOptions &options = SearchOptions());
+SearchResult parallelBfs(const GridMap &grid, int start, int target, SearchContext &context,
+                         SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+} // namespace pathfinding
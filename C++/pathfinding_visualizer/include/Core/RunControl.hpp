@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace pathfinding {
+
+/**
+ * RunControl lets one thread cancel the runs another thread executes.
+ * Runs carry ids handed out by the requester in increasing order;
+ * cancel(id) stops that run and every earlier one, including runs that are
+ * still queued, so a late request can never revive a cancelled one.
+ * cancelled() is a relaxed atomic load, cheap enough to poll per cell.
+ */
+class RunControl {
+public:
+    // Runner: starts run id; false if it was cancelled before it started
+    bool begin(std::uint64_t id);
+    bool cancelled() const {
+        return m_cancelledUpTo.load(std::memory_order_relaxed) >= m_current.load(std::memory_order_relaxed);
+    }
+
+    // Any thread
+    void cancel(std::uint64_t upToId);
+
+private:
+    std::atomic<std::uint64_t> m_current{0};
+    std::atomic<std::uint64_t> m_cancelledUpTo{0};
+};
+
+} // namespace pathfinding
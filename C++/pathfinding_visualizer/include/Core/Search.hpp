@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Core/GridMap.hpp"
+#include "Core/OpenList.hpp"
+#include "Core/SearchContext.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace pathfinding {
+
+enum class Algorithm {
+    BFS,
+    Dijkstra,
+    AStar,
+    JPS,
+    BlockJPS,
+    BidirectionalBFS,
+    BidirectionalAStar,
+    ParallelBFS,
+    FlowField,
+    DStarLite,
+    HPA,
+    ThetaStar,
+    LazyThetaStar
+};
+
+const char *algorithmName(Algorithm algo);
+
+enum class Connectivity {
+    Four,
+    Eight
+};
+
+/**
+ * Which diagonal steps an 8-connected search may take. A diagonal step passes
+ * the two side cells that are orthogonal neighbors of both of its ends.
+ */
+enum class CornerCutting {
+    Never,   // both side cells must be free: paths keep clear of wall corners
+    OneSide, // one free side cell is enough: may clip a corner, never slips between two walls
+    Always   // only the destination must be free
+};
+
+const char *cornerCuttingName(CornerCutting corners);
+
+// BFS, Dijkstra and A* honour Connectivity::Eight; the other algorithms always move 4-connected,
+// except the any-angle ones, whose paths are polylines (see AnyAngle.hpp)
+bool supportsEightConnectivity(Algorithm algo);
+bool isAnyAngle(Algorithm algo);
+
+// Fixed-point step lengths of 8-connected searches; 41/29 is a convergent of sqrt(2) (0.03% off)
+constexpr int StraightStep = 29;
+constexpr int DiagonalStep = 41;
+
+// Distance-field value of cells that cannot reach (or be reached from) the source
+constexpr int Unreachable = -1;
+
+/**
+ * Hot-path counters of one run, filled when SearchOptions::counters is set.
+ * The open-list searches (BFS, Dijkstra, A*, JPS, the bidirectional ones,
+ * the any-angle ones and Parallel BFS) fill every field; BFS queues and
+ * frontiers count as open lists, with no stale pops. The flow field, D* Lite
+ * and HPA* keep their own structures between queries and only split the time.
+ * bytesAllocated is the scratch memory the run had to grow: a warm
+ * SearchContext makes it zero.
+ */
+struct SearchCounters {
+    bool measured = false; // false: counting was off and every other field is zero
+    std::int64_t pushes = 0;
+    std::int64_t pops = 0;
+    std::int64_t stalePops = 0; // popped entries skipped by lazy deletion
+    std::int64_t peakOpen = 0;  // largest open-list (or frontier) size
+    std::int64_t bytesAllocated = 0;
+    double searchMs = 0.0;
+    double pathMs = 0.0;        // path reconstruction, included in SearchStats::elapsedMs
+};
+
+struct SearchStats {
+    std::int64_t nodesExpanded = 0;
+    std::int64_t nodesGenerated = 0;
+    double elapsedMs = 0.0;
+    SearchCounters counters;
+};
+
+/**
+ * Per-run settings. Apart from the movement model they only change how fast
+ * the result is found, not the result.
+ */
+struct SearchOptions {
+    QueueKind queue = QueueKind::BinaryHeap; // open list used by Dijkstra, A* and JPS
+    int threads = 0;                         // parallel searches; <= 0 uses every hardware thread
+    Connectivity connectivity = Connectivity::Four;
+    CornerCutting corners = CornerCutting::Never; // diagonal rule when 8-connected
+    bool reachabilityCheck = true;                // runSearch() answers disconnected pairs from a ComponentMap
+    bool counters = false;                        // fill SearchStats::counters; off costs nothing
+};
+
+/**
+ * Result of one query. path holds flat cell indices from start to target
+ * (inclusive) and is empty when no path exists or the search was aborted.
+ * pathCost is the sum of GridMap::cost() of every cell entered after start.
+ * When 8-connected each entered cost is weighted by StraightStep or
+ * DiagonalStep, so pathCost is in 1/StraightStep cell units.
+ */
+struct SearchResult {
+    bool found = false;
+    bool aborted = false;
+    int pathCost = 0;
+    std::vector<int> path;
+    SearchStats stats;
+};
+
+/**
+ * Optional hooks into a running search. The default implementation does nothing,
+ * so headless callers can simply pass nullptr.
+ */
+class SearchObserver {
+public:
+    virtual ~SearchObserver() = default;
+
+    // Called once for every expanded (popped) cell, in expansion order.
+    virtual void onVisit(int cell) { (void)cell; }
+    // Same for cells expanded by the backward half of a bidirectional search
+    virtual void onVisitBackward(int cell) { onVisit(cell); }
+    // Polled between expansions; returning true stops the search.
+    virtual bool shouldAbort() const { return false; }
+};
+
+/**
+ * Searches over a GridMap (GridMap::Wall cells are blocked), 4- or 8-connected
+ * as options.connectivity says. start and target are flat cell indices.
+ * Dijkstra and A* honour cell costs; BFS minimizes the number of steps.
+ * A* uses the Manhattan distance when 4-connected and the octile distance
+ * when 8-connected.
+ *
+ * The overloads without a SearchContext use one kept per calling thread.
+ */
+SearchResult bfs(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                 const SearchOptions &options = SearchOptions());
+SearchResult dijkstra(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                      const SearchOptions &options = SearchOptions());
+SearchResult aStar(const GridMap &grid, int start, int target, SearchObserver *observer = nullptr,
+                   const SearchOptions &options = SearchOptions());
+
+SearchResult bfs(const GridMap &grid, int start, int target, SearchContext &context,
+                 SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+SearchResult dijkstra(const GridMap &grid, int start, int target, SearchContext &context,
+                      SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+SearchResult aStar(const GridMap &grid, int start, int target, SearchContext &context,
+                   SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+SearchResult runSearch(Algorithm algo, const GridMap &grid, int start, int target,
+                       SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+// context is used by every grid search; the flow field, D* Lite and HPA* keep their own state per thread
+SearchResult runSearch(Algorithm algo, const GridMap &grid, int start, int target, SearchContext &context,
+                       SearchObserver *observer = nullptr, const SearchOptions &options = SearchOptions());
+
+} // namespace pathfinding
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Core/OpenList.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * Scratch memory of the single-threaded searches (BFS, Dijkstra, A*):
+ * per-cell distances, parents and closed flags plus the open lists.
+ * The bidirectional searches run their target side on backward(), a
+ * second context owned by this one.
+ * A context keeps its buffers between queries, so once it has seen a map
+ * of a given size the searches never allocate scratch memory.
+ *
+ * Each cell record carries the generation that last wrote it, and reset()
+ * only bumps the current generation: records from older queries read as
+ * unreached and open, so a reset is O(1) however large the map.
+ * Not thread-safe: use one context per thread.
+ */
+class SearchContext {
+public:
+    // Distance of cells not reached yet
+    static constexpr int Infinity = std::numeric_limits<int>::max() / 4;
+
+    // Sizes the per-cell buffers for cells and marks every cell unreached and open
+    void reset(int cells);
+
+    int dist(int cell) const { return current(cell) ? m_nodes[std::size_t(cell)].dist : Infinity; }
+    void setDist(int cell, int d) { touch(cell).dist = d; }
+    // -1 for the start and for cells not reached yet
+    int parent(int cell) const { return current(cell) ? m_nodes[std::size_t(cell)].parent : -1; }
+    void setParent(int cell, int parent) { touch(cell).parent = std::int32_t(parent); }
+    bool closed(int cell) const { return m_nodes[std::size_t(cell)].stamp == (m_generation | 1u); }
+    void setClosed(int cell) { touch(cell).stamp = m_generation | 1u; }
+
+    // Empty FIFO with room for every cell
+    std::vector<int> &queue();
+
+    // Empty open lists; the bucket queue is rebuilt only when a wider span is asked for
+    BinaryHeap &binaryHeap() { m_binary.clear(); return m_binary; }
+    QuaternaryHeap &quaternaryHeap() { m_quaternary.clear(); return m_quaternary; }
+    RadixHeap &radixHeap() { m_radix.clear(); return m_radix; }
+    BucketQueue &bucketQueue(int span);
+
+    // Context of a bidirectional search's target side; created on first use, then kept with this one
+    SearchContext &backward();
+
+    int cells() const { return int(m_nodes.size()); }
+    // Bytes held by all buffers, open lists and backward() included (capacity, not size)
+    std::size_t memoryBytes() const;
+    // Fixed per-cell part: one cell record plus one FIFO slot
+    static constexpr std::size_t BytesPerCell = 12 + sizeof(int);
+
+private:
+    // stamp is the generation of the last write, with bit 0 set once the cell is closed
+    struct Node {
+        std::uint32_t stamp;
+        std::int32_t dist;
+        std::int32_t parent;
+    };
+    static_assert(sizeof(Node) == 12, "cell records should stay 12 bytes");
+
+    bool current(int cell) const { return (m_nodes[std::size_t(cell)].stamp & ~1u) == m_generation; }
+    Node &touch(int cell) {
+        Node &node = m_nodes[std::size_t(cell)];
+        if ((node.stamp & ~1u) != m_generation) node = {m_generation, Infinity, -1};
+        return node;
+    }
+
+    std::vector<Node> m_nodes;
+    std::uint32_t m_generation = 0; // even; stamps below it are stale
+    std::vector<int> m_queue;
+    BinaryHeap m_binary;
+    QuaternaryHeap m_quaternary;
+    RadixHeap m_radix;
+    BucketQueue m_bucket;
+    int m_bucketSpan = 0;
+    std::unique_ptr<SearchContext> m_backward;
+};
+
+} // namespace pathfinding
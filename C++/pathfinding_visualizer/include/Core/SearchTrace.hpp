@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Core/Search.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * The record of one search, taken at full speed and replayed afterwards at
+ * any pace. Each event is one uint32: the kind in the top two bits and the
+ * flat cell index below, so a trace covers grids of up to 2^30 cells at
+ * 4 bytes per expanded cell. Visits come in expansion order, followed by
+ * the path (for any-angle algorithms: the corners of the polyline).
+ */
+struct SearchTrace {
+    enum Kind : std::uint32_t {
+        Visit = 0,
+        VisitBackward = 1, // expanded by the target side of a bidirectional search
+        Path = 2
+    };
+    static constexpr int CellBits = 30;
+    static constexpr int MaxCells = 1 << CellBits;
+
+    int rows = 0;
+    int cols = 0;
+    Algorithm algorithm = Algorithm::BFS;
+    int start = -1;
+    int target = -1;
+    bool found = false;
+    int pathCost = 0;
+    SearchStats stats;
+    std::vector<std::uint32_t> events;
+
+    static Kind kindOf(std::uint32_t event) { return Kind(event >> CellBits); }
+    static int cellOf(std::uint32_t event) { return int(event & (std::uint32_t(MaxCells) - 1)); }
+
+    void add(Kind kind, int cell) { events.push_back((std::uint32_t(kind) << CellBits) | std::uint32_t(cell)); }
+    // Takes over the outcome of result and appends its path
+    void finish(const SearchResult &result);
+    std::size_t memoryBytes() const { return events.capacity() * sizeof(std::uint32_t); }
+};
+
+/**
+ * Observer that appends every expansion to a trace. Abort polls are
+ * forwarded to abortSource, so a recorded run can still be cancelled.
+ */
+class TraceRecorder : public SearchObserver {
+public:
+    explicit TraceRecorder(SearchTrace &trace, const SearchObserver *abortSource = nullptr)
+        : m_trace(trace), m_abortSource(abortSource) {}
+
+    void onVisit(int cell) override { m_trace.add(SearchTrace::Visit, cell); }
+    void onVisitBackward(int cell) override { m_trace.add(SearchTrace::VisitBackward, cell); }
+    bool shouldAbort() const override { return m_abortSource && m_abortSource->shouldAbort(); }
+
+private:
+    SearchTrace &m_trace;
+    const SearchObserver *m_abortSource;
+};
+
+/**
+ * Binary trace file (".pftrace"), little-endian:
+ *   char magic[4] = "PFTR"; uint32 version; uint32 rows; uint32 cols;
+ *   uint32 algorithm; int32 start; int32 target; uint32 found; int32 pathCost;
+ *   int64 nodesExpanded; int64 nodesGenerated; float64 elapsedMs;
+ *   uint64 eventCount; eventCount uint32 events.
+ * Loading memory-maps the file.
+ */
+bool loadTrace(const std::string &path, SearchTrace &out, std::string *error = nullptr);
+bool saveTrace(const std::string &path, const SearchTrace &trace, std::string *error = nullptr);
+
+} // namespace pathfinding
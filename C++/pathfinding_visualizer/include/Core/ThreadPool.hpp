@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pathfinding {
+
+/**
+ * Fixed set of worker threads for data-parallel loops. run() gives every
+ * worker an equal contiguous range of task indices; a worker that runs dry
+ * steals the upper half of another worker's remaining range, so uneven
+ * tasks still balance while neighbouring tasks mostly stay on one thread.
+ * The calling thread works too, as worker 0. Concurrent run() calls are serialized.
+ */
+class ThreadPool {
+public:
+    // threads <= 0 uses std::thread::hardware_concurrency(); the count includes the caller
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const { return int(m_threads.size()) + 1; }
+
+    // Calls fn(task, worker) for every task in [0, tasks) and returns when all are done.
+    // worker is in [0, size()) and is stable for the duration of one call.
+    void run(int tasks, const std::function<void(int task, int worker)> &fn);
+
+    // Process-wide pool with the given size (same rule as the constructor), created on first use
+    static ThreadPool &shared(int threads = 0);
+
+private:
+    // Tasks [begin, end) still owned by one worker; padded to keep workers off each other's cache lines
+    struct alignas(64) Range {
+        std::mutex mutex;
+        int begin = 0;
+        int end = 0;
+    };
+
+    void workerLoop(int worker);
+    void drain(int worker);
+    bool takeOwn(int worker, int &task);
+    bool steal(int worker, int &task);
+
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<Range[]> m_ranges; // one per worker
+    std::mutex m_runMutex; // one run() at a time
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::atomic<const std::function<void(int, int)> *> m_fn{nullptr};
+    std::atomic<int> m_pending{0}; // tasks not finished yet
+    unsigned m_generation = 0;
+    int m_busy = 0; // workers not done with this generation yet
+    bool m_stop = false;
+};
+
+} // namespace pathfinding
@@ -1,50 +1,113 @@
 #pragma once
 
+#include "Core/GridMap.hpp"
+
+#include <QColor>
 #include <QGraphicsScene>
 #include <QObject>
 #include <QPoint>
 #include <QVector>
 
+#include <cstdint>
+#include <vector>
+
 /**
- * Grid manages QGraphicsScene and Node items.
+ * Grid manages the QGraphicsScene and the single GridItem that draws all cells.
  * It also handles mouse interactions by installing an event filter on the scene.
- * exportModel() returns a copy (QVector) safe to send across threads.
+ * exportModel() returns a flat copy (pathfinding::GridMap) safe to send across threads.
  */
-class Node;
+class GridItem;
+class QGraphicsPathItem;
 class Grid : public QObject {
     Q_OBJECT
 public:
     struct Model {
-        QVector<QVector<int>> grid; // 0 = free, 1 = wall
+        pathfinding::GridMap grid; // GridMap::Free / GridMap::Wall, plus cell costs
         QPoint start;
         QPoint target;
     };
 
+    static constexpr int DefaultCellSize = 22;
+    // One-cell-wide corridors (e.g. MovingAI maps of a single row) are valid grids
+    static constexpr int MinDimension = 1;
+    static constexpr int MaxDimension = 10000;
+    // Brush value that toggles walls; any other brush value paints that cell cost (1-255)
+    static constexpr int WallBrush = 0;
+
     explicit Grid(int rows, int cols, QObject *parent = nullptr);
     ~Grid() override;
 
     QGraphicsScene* scene() const { return m_scene; }
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
+    // Reallocates cell state for a new size; walls are cleared, start/target go to the corners
+    void resize(int rows, int cols, int cellSize = DefaultCellSize);
+
+    // A read-only grid ignores clicks (race views show a snapshot)
+    void setEditable(bool editable) { m_editable = editable; }
+    bool isEditable() const { return m_editable; }
+
+    // What a left click paints: WallBrush or a traversal cost
+    void setBrush(int brush) { m_brush = brush; }
+    int brush() const { return m_brush; }
 
     Model exportModel() const;
+    // Replaces walls and start/target; resizes first if the model's dimensions differ
+    void importModel(const Model &model);
 
     // Called from GUI thread (slots)
     void markVisited(int r, int c);
     void markPath(int r, int c);
+    // Batch variants taking flat cell indices (row * cols + col); one scene update per call
+    void markVisitedCells(const QVector<int> &cells);
+    // Cells reached from the target side of a bidirectional search (own color)
+    void markBackwardVisitedCells(const QVector<int> &cells);
+    void markPathCells(const QVector<int> &cells);
+    // Any-angle path: a line through the centers of the given cells (the polyline's corners)
+    void showPathPolyline(const QVector<int> &cells);
+    // Turns visited and path cells back into plain terrain; walls, costs and start/target stay
+    void clearSearchMarks();
     void reset();
 
+    // Heat-map overlay of a distance field (flat, one entry per cell; negative = unreachable, left clear)
+    void showDistanceField(const QVector<int> &dist);
+    // Overlay tinting each connected region of free cells in its own color (flat region ids, -1 = wall)
+    void showComponents(const QVector<int> &labels);
+    void clearHeatMap();
+    void setHeatMapVisible(bool visible);
+    // Draws the HPA* cluster boundaries over the grid
+    void setClusterBoundsVisible(bool visible);
+    // Color of forward-visited cells (race views tint each algorithm differently)
+    void setVisitedColor(const QColor &color);
+
+signals:
+    // A click changed a wall, a cell cost, the start or the target
+    void edited();
+
 protected:
     // eventFilter to capture mouse clicks on the scene and translate to grid actions
     bool eventFilter(QObject *watched, QEvent *event) override;
 
 private:
-    void toggleWallAtScenePos(const QPointF &scenePos);
+    bool cellAtScenePos(const QPointF &scenePos, int &r, int &c) const;
+    // Sets open cells to state (a GridItem::CellState) with one scene update
+    void markOpenCells(const QVector<int> &cells, uchar state);
+    void paintAtScenePos(const QPointF &scenePos);
+    int costAt(int r, int c) const;
+    void setCostAt(int r, int c, int cost);
     void setStartAtScenePos(const QPointF &scenePos);
     void setTargetAtScenePos(const QPointF &scenePos);
+    void clearPathPolyline();
 
     int m_rows;
     int m_cols;
     QGraphicsScene *m_scene;
-    QVector<QVector<Node*>> m_nodes;
+    GridItem *m_item;
+    QGraphicsPathItem *m_polyline; // created on the first any-angle path, then reused
+    std::vector<std::uint8_t> m_costs; // empty until a non-unit cost is painted
+    int m_brush;
+    bool m_editable;
 
     QPoint m_start;
     QPoint m_target;
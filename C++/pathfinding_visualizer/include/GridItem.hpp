@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QImage>
+#include <QRect>
+#include <QVector>
+
+/**
+ * GridItem is a single QGraphicsItem that draws the whole grid.
+ * Cell states are stored one byte per cell in an indexed QImage, so the
+ * state array and the pixels are the same buffer; the color table maps
+ * states to colors. paint() only draws the exposed cells, scaled with
+ * nearest-neighbor, and subsamples when more than one cell maps to a pixel.
+ *
+ * Note: GridItem methods must be called from the GUI thread.
+ */
+class GridItem : public QGraphicsItem {
+public:
+    enum CellState : uchar {
+        Empty = 0,
+        Wall,
+        Visited,
+        Path,
+        Start,
+        Target,
+        VisitedBackward, // expanded by the target-side half of a bidirectional search
+        // Empty cells with a traversal cost > 1 use TerrainBase..255, darker = costlier
+        TerrainBase = 16
+    };
+
+    // State that shows an empty cell of the given cost (Empty for cost <= 1)
+    static CellState terrainState(int cost);
+    // Empty or terrain: a cell the searches may mark as visited / path
+    static bool isOpen(CellState s) { return s == Empty || s >= TerrainBase; }
+
+    GridItem(int rows, int cols, int cellSize);
+
+    // Reallocates the state buffer (all cells Empty) and changes the item's geometry
+    void resize(int rows, int cols, int cellSize);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    int cellSize() const { return m_cellSize; }
+
+    CellState state(int r, int c) const { return CellState(m_cells.constScanLine(r)[c]); }
+    const uchar *rowData(int r) const { return m_cells.constScanLine(r); }
+    // Sets one cell without scheduling a repaint; call updateCells() afterwards
+    void setStateNoUpdate(int r, int c, CellState s) { m_cells.scanLine(r)[c] = s; }
+    void setState(int r, int c, CellState s);
+    void fill(CellState s);
+    // Changes the color every cell in state s is drawn with
+    void setStateColor(CellState s, QRgb color);
+
+    // Schedules a repaint of the given cell rectangle (x = col, y = row)
+    void updateCells(const QRect &cells);
+
+    // Optional layer drawn over the cells: a Format_Indexed8 image of the grid's
+    // size whose color table carries alpha (index 0 should be transparent)
+    void setOverlay(const QImage &overlay);
+    void clearOverlay();
+    bool hasOverlay() const { return !m_overlay.isNull(); }
+    void setOverlayVisible(bool visible);
+    bool overlayVisible() const { return m_overlayVisible; }
+
+    // Lines every clusterSize cells (the HPA* cluster boundaries); 0 hides them
+    void setClusterSize(int clusterSize);
+    int clusterSize() const { return m_clusterSize; }
+
+private:
+    // Exposed part of an indexed image, keeping every step-th cell
+    static QImage sampleRegion(const QImage &image, int c0, int r0, int c1, int r1, int step);
+
+    int m_rows;
+    int m_cols;
+    int m_cellSize;
+    QImage m_cells; // Format_Indexed8, one CellState per pixel
+    QImage m_overlay;
+    bool m_overlayVisible = true;
+    int m_clusterSize = 0;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QGraphicsView>
+#include <QPoint>
+
+/**
+ * GridView is the QGraphicsView used for the grid.
+ * Mouse wheel zooms around the cursor; Ctrl + left drag pans.
+ * Other mouse presses are passed through to the scene (Grid's event filter).
+ */
+class GridView : public QGraphicsView {
+    Q_OBJECT
+public:
+    explicit GridView(QGraphicsScene *scene, QWidget *parent = nullptr);
+
+protected:
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    bool m_panning;
+    QPoint m_lastPanPos;
+};
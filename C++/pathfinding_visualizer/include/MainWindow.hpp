@@ -1,12 +1,20 @@
 #pragma once
 
+#include "Algorithms/AlgorithmWorker.hpp"
+#include "Core/Search.hpp"
+
 #include <QMainWindow>
 #include <QThread>
 #include <QString>
+#include <QVector>
 
 class Grid;
-class AlgorithmWorker;
+class GridView;
+class TracePlayer;
+class RunReportPanel;
+class RaceWindow;
 class QComboBox;
+class QDockWidget;
 class QSlider;
 class QLabel;
 class QAction;
@@ -14,7 +22,7 @@ class QAction;
 class MainWindow : public QMainWindow {
     Q_OBJECT
 public:
-    explicit MainWindow(QWidget *parent = nullptr);
+    explicit MainWindow(int rows = 30, int cols = 50, QWidget *parent = nullptr);
     ~MainWindow() override;
 
 protected:
@@ -25,28 +33,100 @@ private slots:
     void onReset();
     void onSpeedChanged(int value);
     void onAlgoChanged(const QString &name);
+    void onTurboToggled(bool on);
+    void onBrushChanged(int index);
+    void onQueueChanged(int index);
+    void onMovesChanged(int index);
+    void onResizeGrid();
+    void onOpenMap();
+    void onSaveMap();
+    void onOpenTrace();
+    void onSaveTrace();
+    void onBatch();
+    void onRace();
+    void fitGridToView();
+    void onGridEdited();
+    void onComponentsToggled(bool on);
+    void onPauseToggled(bool on);
+    void onStep();
+    void onTracePosition(qint64 position, qint64 length);
+    void onReportToggled(bool visible);
 
     // Slots to receive worker signals (executed in GUI thread)
-    void handleVisit(int row, int col);
-    void handlePathNode(int row, int col);
-    void handleWorkerFinished();
-    void handleStatus(const QString &text);
+    // Signals from a run other than the current one are dropped
+    void handleTrace(quint64 runId, const SearchTracePtr &trace);
+    void handlePathBatch(quint64 runId, const QVector<int> &cells);
+    void handleSearchStats(quint64 runId, qint64 nodesExpanded, double elapsedMs);
+    void handleScratchMemory(quint64 runId, qint64 bytes, int cells);
+    void handleDistanceField(quint64 runId, const QVector<int> &dist);
+    void handleComponentLabels(quint64 runId, const QVector<int> &labels);
+    void handleWorkerFinished(quint64 runId);
+    void handleStatus(quint64 runId, const QString &text);
 
 private:
     void createToolbar();
     void startAlgorithmOnWorker();
+    void applyGridSize(int rows, int cols);
+    void pushSearchOptions();
+    void startReplan();
+    void requestComponents();
+    // Cancels every run issued so far and forgets them (and the replay), so nothing still queued reaches the grid
+    void cancelAllRuns();
 
     Grid *m_grid;
+    GridView *m_view;
     AlgorithmWorker *m_worker;
     QThread *m_workerThread;
+    // Replays each finished search at the chosen speed
+    TracePlayer *m_player;
+    // Counters of the last search; the searches only count while it is shown
+    RunReportPanel *m_reportPanel;
+    QDockWidget *m_reportDock;
+    // Side-by-side race of several algorithms on a snapshot; created on first use
+    RaceWindow *m_raceWindow;
 
     QAction *m_runAction;
     QAction *m_resetAction;
+    QAction *m_turboAction;
+    QAction *m_resizeAction;
+    QAction *m_openAction;
+    QAction *m_saveAction;
+    QAction *m_openTraceAction;
+    QAction *m_saveTraceAction;
+    QAction *m_batchAction;
+    QAction *m_raceAction;
+    QAction *m_fitAction;
+    QAction *m_heatMapAction;
+    QAction *m_clustersAction;
+    QAction *m_componentsAction;
+    QAction *m_pauseAction;
+    QAction *m_stepAction;
     QComboBox *m_algoSelector;
+    QComboBox *m_brushSelector;
+    QComboBox *m_queueSelector;
+    QComboBox *m_movesSelector;
     QSlider *m_speedSlider;
+    // Scrubs through the replayed trace (one step per event)
+    QSlider *m_traceSlider;
     QLabel *m_statusLabel;
 
     QString m_currentAlgo;
+    QString m_lastRunSummary;
     int m_speedMs;
     bool m_isRunning;
+    bool m_turbo;
+    // A D* Lite plan is on screen: edits replan it instead of waiting for Run
+    bool m_planActive;
+    bool m_replanPending;
+    // A replan's trace is drawn at once instead of replayed
+    bool m_drawAtOnce;
+    // The batch reports its results through status(); keep that text when it finishes
+    bool m_batchRunning;
+    // Run ids: the last one issued, the search/replan/batch on screen and the pending region labels (0 = none)
+    quint64 m_nextRunId = 0;
+    quint64 m_runId = 0;
+    quint64 m_componentsRunId = 0;
+    pathfinding::SearchOptions m_searchOptions;
+    // Options of the search on screen, for its report
+    pathfinding::SearchOptions m_runOptions;
 };
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Algorithms/AlgorithmWorker.hpp"
+#include "Core/Search.hpp"
+#include "Grid.hpp"
+
+#include <QColor>
+#include <QElapsedTimer>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+
+class GridView;
+class TracePlayer;
+class QComboBox;
+class QGridLayout;
+class QLabel;
+class QListWidget;
+class QPushButton;
+
+/**
+ * RaceWindow runs several algorithms at once on one map snapshot and shows
+ * them side by side. Every racer has its own AlgorithmWorker on its own
+ * thread, and all of them search the same read-only GridMap (GridMapPtr),
+ * so edits made in the main window after the snapshot never reach a race.
+ *
+ * While the searches run, each pane shows its live expansion count and
+ * wall time. Once all have finished, their traces are replayed together:
+ * paced by measured search time, the pane that finishes first was the
+ * fastest search; paced by expansions, the one that expanded least.
+ */
+class RaceWindow : public QWidget {
+    Q_OBJECT
+public:
+    explicit RaceWindow(QWidget *parent = nullptr);
+    ~RaceWindow() override;
+
+    // Map, start/target and options of the next race; a race in progress is stopped
+    void setSnapshot(const Grid::Model &model, const pathfinding::SearchOptions &options);
+
+public slots:
+    void start();
+    void stop();
+    // Plays every finished trace again from the start
+    void replay();
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    // Worker signals, matched to their racer by run id (stale ids are dropped)
+    void handleTrace(quint64 runId, const SearchTracePtr &trace);
+    void handleStatus(quint64 runId, const QString &text);
+    void handleWorkerFinished(quint64 runId);
+    void onProgressTick();
+
+private:
+    // A worker thread; kept between races, one per racer
+    struct Lane {
+        AlgorithmWorker *worker = nullptr;
+        QThread *thread = nullptr;
+    };
+
+    struct Racer {
+        pathfinding::Algorithm algorithm = pathfinding::Algorithm::BFS;
+        QColor color;
+        quint64 runId = 0;
+        Grid *grid = nullptr;
+        GridView *view = nullptr;
+        TracePlayer *player = nullptr;
+        QLabel *stats = nullptr;
+        SearchTracePtr trace;
+        qint64 visits = 0; // trace events before the path
+        double searchMs = 0.0;
+        QElapsedTimer clock; // wall time since the run was sent, for the live display
+        QString note;        // why there is no trace (aborted, different regions)
+        bool finished = false;
+    };
+
+    void ensureLanes(int count);
+    void clearRacers();
+    void buildPanes();
+    void startReplay();
+    void fitViews();
+    void updateControls();
+    // Shows the replay position of racer i; the live count comes from onProgressTick()
+    void showReplayPosition(int i, qint64 position);
+    void showResult(int i);
+    int racerOf(quint64 runId) const;
+    bool racing() const;
+
+    Grid::Model m_model;
+    GridMapPtr m_snapshot;
+    pathfinding::SearchOptions m_options;
+
+    QVector<Lane> m_lanes;
+    QVector<Racer> m_racers;
+    quint64 m_nextRunId = 0;
+    QTimer m_progressTimer;
+
+    QListWidget *m_algoList;
+    QComboBox *m_paceSelector;
+    QPushButton *m_startButton;
+    QPushButton *m_replayButton;
+    QLabel *m_snapshotLabel;
+    QLabel *m_summaryLabel;
+    QWidget *m_panes;
+    QGridLayout *m_paneLayout;
+};
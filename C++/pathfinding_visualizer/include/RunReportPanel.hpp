@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Core/Search.hpp"
+#include "Core/SearchTrace.hpp"
+
+#include <QJsonObject>
+#include <QString>
+#include <QWidget>
+
+class QPushButton;
+class QTreeWidget;
+
+/**
+ * RunReportPanel shows the performance report of the last search: work
+ * (expanded and generated nodes), open-list traffic, the split between
+ * searching and path reconstruction, and the scratch memory the run
+ * allocated. The hot-path counters are only filled while the panel is
+ * shown (SearchOptions::counters); traces loaded from disk carry no
+ * counters. "Export JSON..." writes the report as one JSON object.
+ */
+class RunReportPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit RunReportPanel(QWidget *parent = nullptr);
+
+    // A run of the worker, with the options it ran with
+    void showRun(const pathfinding::SearchTrace &trace, const pathfinding::SearchOptions &options);
+    // A trace loaded from file; only its stats are known
+    void showTrace(const pathfinding::SearchTrace &trace, const QString &fileName);
+    void clear();
+
+    const QJsonObject &report() const { return m_report; }
+
+private slots:
+    void onExport();
+
+private:
+    void populate();
+
+    QTreeWidget *m_tree;
+    QPushButton *m_exportButton;
+    QJsonObject m_report;
+};
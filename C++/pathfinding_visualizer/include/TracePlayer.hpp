@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Algorithms/AlgorithmWorker.hpp"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+class Grid;
+
+/**
+ * TracePlayer replays a recorded search onto the Grid from a GUI timer, one
+ * frame's worth of events per tick. Speed, pausing and scrubbing only move
+ * the playback position; the search is never rerun. Seeking forward draws
+ * the events in between, seeking backward clears the search marks and
+ * redraws the prefix.
+ */
+class TracePlayer : public QObject {
+    Q_OBJECT
+public:
+    explicit TracePlayer(Grid *grid, QObject *parent = nullptr);
+
+    // Clears the search marks and plays trace from its first event (unless paused)
+    void load(const SearchTracePtr &trace);
+    // Stops and forgets the trace; the grid keeps what was drawn
+    void clear();
+    const SearchTracePtr &trace() const { return m_trace; }
+
+    qint64 position() const { return m_position; }
+    qint64 length() const { return m_trace ? qint64(m_trace->events.size()) : 0; }
+    bool isPlaying() const { return m_timer.isActive(); }
+
+    // Milliseconds per event; 0 replays the whole trace in about a second
+    void setDelayMs(int ms);
+    // Replays the whole trace in about ms, whatever its length; overrides the delay until set back to 0
+    void setDurationMs(double ms);
+    void setPaused(bool paused);
+
+public slots:
+    void seek(qint64 position);
+    void stepForward() { seek(m_position + 1); }
+    void stepBackward() { seek(m_position - 1); }
+    void finish() { seek(length()); }
+
+signals:
+    void positionChanged(qint64 position, qint64 length);
+    // The last event was drawn by playback (not by a seek)
+    void playbackFinished();
+
+private:
+    void onFrame();
+    // Draws events [from, to) on top of what is shown
+    void apply(qint64 from, qint64 to);
+    void updateTimer();
+
+    Grid *m_grid;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    SearchTracePtr m_trace;
+    qint64 m_position = 0;
+    int m_delayMs = 0;
+    double m_durationMs = 0.0;
+    bool m_paused = false;
+    // Events owed to playback but not yet drawn (fractions of an event at slow speeds)
+    double m_credit = 0.0;
+};
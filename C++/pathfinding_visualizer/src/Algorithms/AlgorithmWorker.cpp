@@ -1,212 +1,290 @@
 #include "Algorithms/AlgorithmWorker.hpp"
-#include <QThread>
-#include <queue>
-#include <limits>
-#include <algorithm>
+#include <QRandomGenerator>
+
+/**
+ * Stops a search within one expansion once its run is cancelled. Progress
+ * itself goes into the run's trace.
+ */
+class WorkerObserver : public pathfinding::SearchObserver {
+public:
+    explicit WorkerObserver(const AlgorithmWorker *worker) : m_worker(worker) {}
+
+    bool shouldAbort() const override { return m_worker->m_control.cancelled(); }
+
+private:
+    const AlgorithmWorker *m_worker;
+};
+
+/**
+ * Records the trace and publishes the expansion count as it goes, so the
+ * GUI can show a long search's progress before its trace arrives.
+ */
+class ProgressRecorder : public pathfinding::TraceRecorder {
+public:
+    ProgressRecorder(pathfinding::SearchTrace &trace, const pathfinding::SearchObserver *abortSource,
+                     AlgorithmWorker *worker)
+        : TraceRecorder(trace, abortSource), m_expanded(worker->m_expanded) {}
+
+    void onVisit(int cell) override { TraceRecorder::onVisit(cell); publish(); }
+    void onVisitBackward(int cell) override { TraceRecorder::onVisitBackward(cell); publish(); }
+
+private:
+    // A relaxed store: the reader only needs a recent value, not ordering with the trace
+    void publish() { m_expanded.store(++m_count, std::memory_order_relaxed); }
+
+    std::atomic<qint64> &m_expanded;
+    qint64 m_count = 0;
+};
+
+namespace {
+
+// The worker's own flow field, planner and graph bypass runSearch(), so their time split is filled in here
+void splitTime(const pathfinding::SearchOptions &options, pathfinding::SearchStats &stats, double pathMs) {
+    if (!options.counters) return;
+    stats.counters.measured = true;
+    stats.counters.pathMs = pathMs;
+    stats.counters.searchMs = stats.elapsedMs - pathMs;
+}
+
+} // namespace
 
 AlgorithmWorker::AlgorithmWorker(QObject *parent)
-    : QObject(parent), m_abortRequested(false)
+    : QObject(parent)
 {}
 
 AlgorithmWorker::~AlgorithmWorker() {}
 
-void AlgorithmWorker::requestAbort() {
-    m_abortRequested = true;
+void AlgorithmWorker::cancelRuns(quint64 upToRun) {
+    m_control.cancel(upToRun);
 }
 
-void AlgorithmWorker::sleepMs(int ms) const {
-    // Sleep in worker thread
-    QThread::msleep(static_cast<unsigned long>(ms));
+bool AlgorithmWorker::beginRun(quint64 runId) {
+    m_runId = runId;
+    if (m_control.begin(runId)) return true;
+    emit status(runId, "Aborted");
+    emit finished(runId);
+    return false;
 }
 
-/**
- * BFS implementation on a grid represented by QVector<QVector<int>>
- * 0 = free, 1 = wall
- */
-void AlgorithmWorker::runBFS(const QVector<QVector<int>> &grid, const QPoint &start, const QPoint &target, int delayMs) {
-    m_abortRequested = false;
-    int rows = grid.size();
-    if (rows == 0) { emit finished(); return; }
-    int cols = grid[0].size();
-
-    std::queue<QPoint> q;
-    QVector<QVector<bool>> seen(rows, QVector<bool>(cols, false));
-    QVector<QVector<QPoint>> parent(rows, QVector<QPoint>(cols, QPoint(-1, -1)));
-
-    q.push(start);
-    seen[start.x()][start.y()] = true;
-
-    const int dr[4] = {1,-1,0,0};
-    const int dc[4] = {0,0,1,-1};
-
-    while (!q.empty() && !m_abortRequested) {
-        QPoint cur = q.front(); q.pop();
-        emit visit(cur.x(), cur.y());
-        sleepMs(delayMs);
-
-        if (cur == target) break;
-
-        for (int i = 0; i < 4; ++i) {
-            int nr = cur.x() + dr[i];
-            int nc = cur.y() + dc[i];
-            if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
-            if (grid[nr][nc] == 1) continue;
-            if (seen[nr][nc]) continue;
-            seen[nr][nc] = true;
-            parent[nr][nc] = cur;
-            q.push(QPoint(nr, nc));
-        }
-    }
+void AlgorithmWorker::setSearchOptions(const pathfinding::SearchOptions &options) {
+    m_options = options;
+}
+
+void AlgorithmWorker::runSearch(quint64 runId, int algorithm, const pathfinding::GridMap &grid, const QPoint &start,
+                                const QPoint &target) {
+    if (!beginRun(runId)) return;
+    runAlgorithm(static_cast<pathfinding::Algorithm>(algorithm), grid, start, target);
+}
+
+void AlgorithmWorker::runSharedSearch(quint64 runId, int algorithm, const GridMapPtr &grid, const QPoint &start,
+                                      const QPoint &target) {
+    if (!beginRun(runId)) return;
+    if (!grid) { emit finished(runId); return; }
+    runAlgorithm(static_cast<pathfinding::Algorithm>(algorithm), *grid, start, target);
+}
+
+void AlgorithmWorker::runBFS(quint64 runId, const pathfinding::GridMap &grid, const QPoint &start,
+                             const QPoint &target) {
+    if (!beginRun(runId)) return;
+    runAlgorithm(pathfinding::Algorithm::BFS, grid, start, target);
+}
 
-    if (m_abortRequested) { emit status("Aborted"); emit finished(); return; }
+void AlgorithmWorker::runDijkstra(quint64 runId, const pathfinding::GridMap &grid, const QPoint &start,
+                                  const QPoint &target) {
+    if (!beginRun(runId)) return;
+    runAlgorithm(pathfinding::Algorithm::Dijkstra, grid, start, target);
+}
+
+void AlgorithmWorker::runAStar(quint64 runId, const pathfinding::GridMap &grid, const QPoint &start,
+                               const QPoint &target) {
+    if (!beginRun(runId)) return;
+    runAlgorithm(pathfinding::Algorithm::AStar, grid, start, target);
+}
 
-    if (!seen[target.x()][target.y()]) {
-        emit status("No path found");
-        emit finished();
-        return;
+void AlgorithmWorker::replan(quint64 runId, const pathfinding::GridMap &grid, const QPoint &start,
+                             const QPoint &target) {
+    if (!beginRun(runId)) return;
+    runAlgorithm(pathfinding::Algorithm::DStarLite, grid, start, target);
+}
+
+void AlgorithmWorker::runBatch(quint64 runId, int algorithm, const pathfinding::GridMap &grid, int count) {
+    if (!beginRun(runId)) return;
+    std::vector<int> freeCells;
+    for (int i = 0; i < grid.size(); ++i)
+        if (!grid.isWall(i)) freeCells.push_back(i);
+    if (freeCells.empty() || count <= 0) { emit status(runId, "No free cells"); emit finished(runId); return; }
+
+    std::vector<pathfinding::BatchQuery> queries(static_cast<std::size_t>(count));
+    auto *rng = QRandomGenerator::global();
+    for (auto &query : queries) {
+        query.start = freeCells[rng->bounded(int(freeCells.size()))];
+        query.target = freeCells[rng->bounded(int(freeCells.size()))];
     }
 
-    // Reconstruct path
-    QVector<QPoint> path;
-    for (QPoint at = target; at != QPoint(-1, -1); at = parent[at.x()][at.y()])
-        path.push_back(at);
-    std::reverse(path.begin(), path.end());
-    for (const QPoint &p : path) {
-        emit pathNode(p.x(), p.y());
-        sleepMs(delayMs);
+    if (!m_batch || m_batchThreads != m_options.threads) {
+        m_batch = std::make_unique<pathfinding::BatchSearch>(m_options.threads);
+        m_batchThreads = m_options.threads;
     }
-    emit finished();
+    WorkerObserver observer(this);
+    const auto results = m_batch->run(grid, queries, static_cast<pathfinding::Algorithm>(algorithm), m_options,
+                                      &observer);
+    const auto &stats = m_batch->lastStats();
+    if (stats.aborted) { emit status(runId, "Aborted"); emit finished(runId); return; }
+
+    QVector<int> cells;
+    for (const auto &result : results)
+        cells.append(QVector<int>(result.path.begin(), result.path.end()));
+    emit pathBatch(runId, cells);
+    emit status(runId, QString("Batch: %1 of %2 solved on %3 threads in %4 ms (%5 queries/s), scratch %6 B/cell per thread")
+                    .arg(stats.solved).arg(stats.queries).arg(stats.threads)
+                    .arg(stats.elapsedMs, 0, 'f', 1)
+                    .arg(stats.elapsedMs > 0 ? stats.queries * 1000.0 / stats.elapsedMs : 0.0, 0, 'f', 0)
+                    .arg(double(m_batch->memoryBytes()) / stats.threads / grid.size(), 0, 'f', 1));
+    emit finished(runId);
 }
 
 /**
- * Dijkstra (uniform weights for now; ready to accept weights if grid uses >1 values)
+ * Uses the same per-thread ComponentMap the searches check against, so an
+ * edit is repaired once for both.
  */
-void AlgorithmWorker::runDijkstra(const QVector<QVector<int>> &grid, const QPoint &start, const QPoint &target, int delayMs) {
-    m_abortRequested = false;
-    int rows = grid.size();
-    if (rows == 0) { emit finished(); return; }
-    int cols = grid[0].size();
-
-    const int INF = std::numeric_limits<int>::max() / 4;
-    QVector<QVector<int>> dist(rows, QVector<int>(cols, INF));
-    QVector<QVector<QPoint>> parent(rows, QVector<QPoint>(cols, QPoint(-1,-1)));
-
-    using NodeT = std::pair<int, QPoint>;
-    auto cmp = [](const NodeT &a, const NodeT &b){ return a.first > b.first; };
-    std::priority_queue<NodeT, std::vector<NodeT>, decltype(cmp)> pq(cmp);
-
-    dist[start.x()][start.y()] = 0;
-    pq.push({0, start});
-
-    const int dr[4] = {1,-1,0,0};
-    const int dc[4] = {0,0,1,-1};
-
-    while (!pq.empty() && !m_abortRequested) {
-        auto [d, pos] = pq.top(); pq.pop();
-        int r = pos.x(), c = pos.y();
-        if (d != dist[r][c]) continue;
-
-        emit visit(r, c);
-        sleepMs(delayMs);
-
-        if (pos == target) break;
-
-        for (int i=0;i<4;++i) {
-            int nr = r + dr[i], nc = c + dc[i];
-            if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
-            if (grid[nr][nc] == 1) continue;
-            int w = 1; // default weight; if grid[r][c] > 1 treat as weight
-            int nd = d + w;
-            if (nd < dist[nr][nc]) {
-                dist[nr][nc] = nd;
-                parent[nr][nc] = pos;
-                pq.push({nd, QPoint(nr,nc)});
-            }
-        }
+void AlgorithmWorker::showComponents(quint64 runId, const pathfinding::GridMap &grid) {
+    m_runId = runId;
+    if (grid.empty() || !m_control.begin(runId)) return;
+    WorkerObserver observer(this);
+    const auto &components = pathfinding::componentsFor(grid, m_options, &observer);
+    if (components.empty()) return;
+    QVector<int> labels(grid.size());
+    for (int i = 0; i < grid.size(); ++i)
+        labels[i] = components.component(i);
+    emit componentLabels(runId, labels);
+    const auto &updated = components.lastUpdate();
+    emit status(runId, QString("%1 connected regions (%2 in %3 ms)")
+                    .arg(components.componentCount())
+                    .arg(updated.incremental ? QString("%1 cells relabeled").arg(updated.cellsRelabeled)
+                                             : QString("labeled from scratch"))
+                    .arg(updated.elapsedMs, 0, 'f', 1));
+}
+
+/**
+ * Flow-field runs go through the worker's own FlowField so the field survives
+ * between runs: the next run only repairs what the wall edits touched.
+ */
+pathfinding::SearchResult AlgorithmWorker::runFlowField(const pathfinding::GridMap &grid, int start, int target,
+                                                        pathfinding::SearchObserver *observer) {
+    const auto &updated = m_flowField.update(grid, target, observer);
+    if (updated.aborted) {
+        pathfinding::SearchResult aborted;
+        aborted.aborted = true;
+        return aborted;
     }
 
-    if (m_abortRequested) { emit status("Aborted"); emit finished(); return; }
+    QVector<int> field(grid.size());
+    for (int i = 0; i < grid.size(); ++i)
+        field[i] = m_flowField.distance(i);
+    emit distanceField(m_runId, field);
+
+    auto result = m_flowField.query(start);
+    const double walkMs = result.stats.elapsedMs;
+    result.stats.nodesExpanded = updated.cellsRecomputed;
+    result.stats.elapsedMs += updated.elapsedMs;
+    splitTime(m_options, result.stats, walkMs);
+    emit status(m_runId, updated.incremental
+                    ? QString("Flow field repaired: %1 cells changed").arg(updated.cellsChanged)
+                    : QString("Flow field rebuilt"));
+    return result;
+}
 
-    if (dist[target.x()][target.y()] == INF) {
-        emit status("No path found");
-        emit finished();
-        return;
-    }
+/**
+ * D* Lite runs keep the planner's state, so a rerun after an edit only
+ * re-expands the cells whose cost-to-target the edit changed.
+ */
+pathfinding::SearchResult AlgorithmWorker::runDStarLite(const pathfinding::GridMap &grid, int start, int target,
+                                                        pathfinding::SearchObserver *observer) {
+    auto result = m_planner.plan(grid, start, target, observer);
+    const auto &planned = m_planner.lastPlan();
+    splitTime(m_options, result.stats, planned.pathMs);
+    if (!result.aborted)
+        emit status(m_runId, planned.incremental
+                        ? QString("D* Lite replanned: %1 cells changed, %2 expanded")
+                              .arg(planned.cellsChanged).arg(planned.expanded)
+                        : QString("D* Lite planned from scratch"));
+    return result;
+}
 
-    QVector<QPoint> path;
-    for (QPoint at = target; at != QPoint(-1,-1); at = parent[at.x()][at.y()])
-        path.push_back(at);
-    std::reverse(path.begin(), path.end());
-    for (const QPoint &p : path) {
-        emit pathNode(p.x(), p.y());
-        sleepMs(delayMs);
+/**
+ * HPA* runs reuse the worker's abstract graph; wall edits since the last
+ * run only rebuild the clusters they touched.
+ */
+pathfinding::SearchResult AlgorithmWorker::runHierarchical(const pathfinding::GridMap &grid, int start, int target,
+                                                           pathfinding::SearchObserver *observer) {
+    const auto &updated = m_hierarchy.update(grid, observer);
+    if (updated.aborted) {
+        pathfinding::SearchResult aborted;
+        aborted.aborted = true;
+        return aborted;
     }
-    emit finished();
+    emit status(m_runId, QString("HPA*: %1 of %2 clusters rebuilt in %3 ms, %4 abstract nodes")
+                    .arg(updated.clustersRebuilt)
+                    .arg(m_hierarchy.clusterCount())
+                    .arg(updated.elapsedMs, 0, 'f', 1)
+                    .arg(m_hierarchy.nodeCount()));
+    auto result = m_hierarchy.query(grid, start, target, observer);
+    splitTime(m_options, result.stats, m_hierarchy.lastRefineMs());
+    return result;
 }
 
 /**
- * A* with Manhattan heuristic
+ * Runs one core search at full speed into a trace and sends it to the GUI,
+ * which replays it at whatever pace the user picks.
+ * QPoint uses x = row, y = col, matching Grid.
  */
-void AlgorithmWorker::runAStar(const QVector<QVector<int>> &grid, const QPoint &start, const QPoint &target, int delayMs) {
-    m_abortRequested = false;
-    int rows = grid.size();
-    if (rows == 0) { emit finished(); return; }
-    int cols = grid[0].size();
-
-    const int INF = std::numeric_limits<int>::max() / 4;
-    QVector<QVector<int>> gscore(rows, QVector<int>(cols, INF));
-    QVector<QVector<QPoint>> parent(rows, QVector<QPoint>(cols, QPoint(-1,-1)));
-
-    using NodeT = std::pair<int, QPoint>; // fscore, pos
-    auto cmp = [](const NodeT &a, const NodeT &b){ return a.first > b.first; };
-    std::priority_queue<NodeT, std::vector<NodeT>, decltype(cmp)> open(cmp);
-
-    gscore[start.x()][start.y()] = 0;
-    int f0 = manhattan(start.x(), start.y(), target.x(), target.y());
-    open.push({f0, start});
-
-    const int dr[4] = {1,-1,0,0};
-    const int dc[4] = {0,0,1,-1};
-
-    while (!open.empty() && !m_abortRequested) {
-        auto [f, pos] = open.top(); open.pop();
-        int r = pos.x(), c = pos.y();
-
-        emit visit(r, c);
-        sleepMs(delayMs);
-
-        if (pos == target) break;
-
-        for (int i=0;i<4;++i) {
-            int nr = r + dr[i], nc = c + dc[i];
-            if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
-            if (grid[nr][nc] == 1) continue;
-            int tentative = gscore[r][c] + 1;
-            if (tentative < gscore[nr][nc]) {
-                parent[nr][nc] = pos;
-                gscore[nr][nc] = tentative;
-                int h = manhattan(nr, nc, target.x(), target.y());
-                int nf = tentative + h;
-                open.push({nf, QPoint(nr,nc)});
-            }
+void AlgorithmWorker::runAlgorithm(pathfinding::Algorithm algo, const pathfinding::GridMap &grid,
+                                   const QPoint &start, const QPoint &target) {
+    const quint64 runId = m_runId;
+    m_expanded.store(0, std::memory_order_relaxed);
+    m_progressRun.store(runId, std::memory_order_release);
+    if (grid.empty()) { emit finished(runId); return; }
+
+    WorkerObserver observer(this);
+    const int startCell = grid.index(start.x(), start.y());
+    const int targetCell = grid.index(target.x(), target.y());
+    // Different regions: nothing to replay, and the incremental planners keep their state for the next run
+    if (m_options.reachabilityCheck) {
+        const auto &components = pathfinding::componentsFor(grid, m_options, &observer);
+        if (components.empty()) { emit status(runId, "Aborted"); emit finished(runId); return; }
+        if (!components.reachable(startCell, targetCell)) {
+            emit searchStats(runId, 0, 0.0);
+            emit status(runId, "No path: start and target are in different regions");
+            emit finished(runId);
+            return;
         }
     }
 
-    if (m_abortRequested) { emit status("Aborted"); emit finished(); return; }
-
-    if (gscore[target.x()][target.y()] == INF) {
-        emit status("No path found");
-        emit finished();
-        return;
-    }
-
-    QVector<QPoint> path;
-    for (QPoint at = target; at != QPoint(-1,-1); at = parent[at.x()][at.y()])
-        path.push_back(at);
-    std::reverse(path.begin(), path.end());
-    for (const QPoint &p : path) {
-        emit pathNode(p.x(), p.y());
-        sleepMs(delayMs);
-    }
-    emit finished();
+    auto trace = std::make_shared<pathfinding::SearchTrace>();
+    trace->rows = grid.rows();
+    trace->cols = grid.cols();
+    trace->algorithm = algo;
+    trace->start = startCell;
+    trace->target = targetCell;
+    ProgressRecorder recorder(*trace, &observer, this);
+    pathfinding::SearchResult result;
+    if (algo == pathfinding::Algorithm::FlowField)
+        result = runFlowField(grid, startCell, targetCell, &recorder);
+    else if (algo == pathfinding::Algorithm::DStarLite)
+        result = runDStarLite(grid, startCell, targetCell, &recorder);
+    else if (algo == pathfinding::Algorithm::HPA)
+        result = runHierarchical(grid, startCell, targetCell, &recorder);
+    else
+        result = pathfinding::runSearch(algo, grid, startCell, targetCell, m_context, &recorder, m_options);
+
+    if (result.aborted) { emit status(runId, "Aborted"); emit finished(runId); return; }
+
+    trace->finish(result);
+    emit traceRecorded(runId, trace);
+    emit searchStats(runId, result.stats.nodesExpanded, result.stats.elapsedMs);
+    if (algo == pathfinding::Algorithm::BFS || algo == pathfinding::Algorithm::Dijkstra
+        || algo == pathfinding::Algorithm::AStar)
+        emit scratchMemory(runId, qint64(m_context.memoryBytes()), m_context.cells());
+    if (!result.found) emit status(runId, "No path found");
+    emit finished(runId);
 }
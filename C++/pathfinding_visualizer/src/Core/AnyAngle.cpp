@@ -0,0 +1,164 @@
+#include "Core/AnyAngle.hpp"
+#include "Core/LineOfSight.hpp"
+#include "SearchInternal.hpp"
+
+#include <cmath>
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+// Fixed-point units per cell for g and h; fine enough that rounding never reorders real lengths much
+constexpr double kScale = 1024.0;
+
+double euclid(const GridMap &grid, int a, int b) {
+    const double dr = grid.rowOf(a) - grid.rowOf(b), dc = grid.colOf(a) - grid.colOf(b);
+    return std::sqrt(dr * dr + dc * dc); // std::hypot's overflow care is not needed for grid distances
+}
+
+int scaled(const GridMap &grid, int a, int b) {
+    return int(std::lround(euclid(grid, a, b) * kScale));
+}
+
+// Built once per map contents and thread; the walls are packed twice, so rebuilding per query would dominate
+const LineOfSight &lineOfSightFor(const GridMap &grid) {
+    thread_local LineOfSight cached;
+    if (cached.empty() || cached.version() != grid.version())
+        cached = LineOfSight(grid);
+    return cached;
+}
+
+/**
+ * Theta* keeps A*'s loop but lets a neighbor inherit the current cell's
+ * parent when that parent can see it ("path 2"). Lazy Theta* always takes
+ * path 2 when generating and repairs the parent on expansion, trading line
+ * of sight checks per neighbor for one per expanded cell.
+ * The start's parent link is -1 in the context, so "parent" below falls
+ * back to the cell itself there.
+ */
+template <bool Lazy, typename Counters>
+SearchResult anyAngleWith(Counters &counters, SearchContext &context, const LineOfSight &los, const GridMap &grid,
+                          int start, int target, SearchObserver *observer) {
+    using Moves = EightWay<CornerCutting::Never>;
+    SearchResult result;
+    const auto t0 = Clock::now();
+
+    context.reset(grid.size());
+    BinaryHeap &open = context.binaryHeap();
+    context.setDist(start, 0);
+    context.setParent(start, -1);
+    const int h0 = scaled(grid, start, target);
+    open.push(h0, h0, start);
+    counters.pushed(open.size());
+    auto parentOf = [&](int cell) {
+        const int p = context.parent(cell);
+        return p == -1 ? cell : p;
+    };
+
+    while (!open.empty()) {
+        if (observer && observer->shouldAbort()) { result.aborted = true; break; }
+        const int cur = open.pop().cell;
+        counters.popped();
+        if (context.closed(cur)) { counters.stale(); continue; }
+        context.setClosed(cur);
+
+        if constexpr (Lazy) {
+            // Generated on the assumption that its parent sees it; if not, take the best expanded neighbor
+            const int p = context.parent(cur);
+            if (p != -1 && !los.visible(p, cur)) {
+                int best = INF, bestParent = -1;
+                Moves::forEach(grid, cur, [&](int nb, int) {
+                    if (!context.closed(nb)) return;
+                    const int through = context.dist(nb) + scaled(grid, nb, cur);
+                    if (through < best) { best = through; bestParent = nb; }
+                });
+                if (bestParent != -1) {
+                    context.setDist(cur, best);
+                    context.setParent(cur, bestParent);
+                }
+            }
+        }
+
+        ++result.stats.nodesExpanded;
+        if (observer) observer->onVisit(cur);
+
+        if (cur == target) break;
+
+        const int p = parentOf(cur);
+        Moves::forEach(grid, cur, [&](int nb, int) {
+            if (context.closed(nb)) return;
+            int from = cur;
+            if constexpr (Lazy) from = p;
+            else if (p != cur && los.visible(p, nb)) from = p;
+            const int tentative = context.dist(from) + scaled(grid, from, nb);
+            if (tentative < context.dist(nb)) {
+                context.setDist(nb, tentative);
+                context.setParent(nb, from);
+                const int h = scaled(grid, nb, target);
+                open.push(tentative + h, h, nb);
+                counters.pushed(open.size());
+                ++result.stats.nodesGenerated;
+            }
+        });
+    }
+
+    if (!result.aborted && context.closed(target)) {
+        const auto tPath = counters.pathStart();
+        reconstructPath(context, target, result.path);
+        counters.pathBuilt(tPath);
+        counters.allocated(result.path.capacity() * sizeof(int));
+        double length = 0.0;
+        for (std::size_t i = 1; i < result.path.size(); ++i)
+            length += euclid(grid, result.path[i - 1], result.path[i]);
+        result.found = true;
+        result.pathCost = int(std::lround(length * StraightStep * grid.minCost()));
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+template <bool Lazy>
+SearchResult runAnyAngle(const GridMap &grid, int start, int target, SearchContext &context,
+                         SearchObserver *observer, const SearchOptions &options) {
+    if (!validQuery(grid, start, target)) return SearchResult();
+    if (grid.minCost() != grid.maxCost()) {
+        SearchOptions eightWay = options;
+        eightWay.connectivity = Connectivity::Eight;
+        eightWay.corners = CornerCutting::Never;
+        return aStar(grid, start, target, context, observer, eightWay);
+    }
+    const LineOfSight &los = lineOfSightFor(grid);
+    return withCounters(options, [&](auto counters) {
+        counters.trackContext(context);
+        SearchResult result = anyAngleWith<Lazy>(counters, context, los, grid, start, target, observer);
+        counters.settleContext(context);
+        counters.report(result.stats);
+        return result;
+    });
+}
+
+} // namespace
+
+SearchResult thetaStar(const GridMap &grid, int start, int target, SearchObserver *observer,
+                       const SearchOptions &options) {
+    return runAnyAngle<false>(grid, start, target, threadContext(), observer, options);
+}
+
+SearchResult thetaStar(const GridMap &grid, int start, int target, SearchContext &context,
+                       SearchObserver *observer, const SearchOptions &options) {
+    return runAnyAngle<false>(grid, start, target, context, observer, options);
+}
+
+SearchResult lazyThetaStar(const GridMap &grid, int start, int target, SearchObserver *observer,
+                           const SearchOptions &options) {
+    return runAnyAngle<true>(grid, start, target, threadContext(), observer, options);
+}
+
+SearchResult lazyThetaStar(const GridMap &grid, int start, int target, SearchContext &context,
+                           SearchObserver *observer, const SearchOptions &options) {
+    return runAnyAngle<true>(grid, start, target, context, observer, options);
+}
+
+} // namespace pathfinding
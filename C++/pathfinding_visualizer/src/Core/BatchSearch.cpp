@@ -0,0 +1,72 @@
+#include "Core/BatchSearch.hpp"
+#include "SearchInternal.hpp"
+
+namespace pathfinding {
+
+namespace {
+
+// Passes only shouldAbort() on, so one observer can serve every pool thread
+class AbortForwarder : public SearchObserver {
+public:
+    explicit AbortForwarder(SearchObserver *source) : m_source(source) {}
+    bool shouldAbort() const override { return m_source->shouldAbort(); }
+
+private:
+    SearchObserver *m_source;
+};
+
+} // namespace
+
+BatchSearch::BatchSearch(int threads)
+    : m_pool(threads),
+      m_contexts(std::size_t(m_pool.size()))
+{}
+
+std::vector<SearchResult> BatchSearch::run(const GridMap &grid, const std::vector<BatchQuery> &queries,
+                                           Algorithm algo, const SearchOptions &options, SearchObserver *observer) {
+    const auto t0 = detail::Clock::now();
+    std::vector<SearchResult> results(queries.size());
+    AbortForwarder forwarder(observer);
+    SearchObserver *abortOnly = observer ? &forwarder : nullptr;
+    // Checked here against one shared map rather than a per-thread copy in every worker
+    SearchOptions searchOptions = options;
+    searchOptions.reachabilityCheck = false;
+    bool checkReachability = options.reachabilityCheck;
+    if (checkReachability)
+        checkReachability = !m_components.update(grid, options.connectivity == Connectivity::Eight
+                                                            && options.corners == CornerCutting::Always,
+                                                 abortOnly).aborted;
+    // One task per query: stealing evens out the mix of short and long paths. Every worker reads grid,
+    // including version() for its per-thread caches; that is a plain read, since GridMap draws ids on edit
+    m_pool.run(int(queries.size()), [&](int task, int worker) {
+        const BatchQuery &query = queries[std::size_t(task)];
+        if (observer && observer->shouldAbort()) {
+            results[std::size_t(task)].aborted = true;
+            return;
+        }
+        if (checkReachability && detail::validQuery(grid, query.start, query.target)
+            && !m_components.reachable(query.start, query.target))
+            return;
+        results[std::size_t(task)] = runSearch(algo, grid, query.start, query.target,
+                                               m_contexts[std::size_t(worker)], abortOnly, searchOptions);
+    });
+
+    m_stats = BatchStats();
+    m_stats.aborted = observer && observer->shouldAbort();
+    m_stats.queries = int(queries.size());
+    m_stats.threads = m_pool.size();
+    for (const SearchResult &result : results) {
+        if (result.found) ++m_stats.solved;
+        m_stats.nodesExpanded += result.stats.nodesExpanded;
+    }
+    m_stats.elapsedMs = detail::elapsedSince(t0);
+    return results;
+}
+
+std::size_t BatchSearch::memoryBytes() const {
+    std::size_t bytes = m_components.memoryBytes();
+    for (const SearchContext &context : m_contexts) bytes += context.memoryBytes();
+    return bytes;
+}
+
+} // namespace pathfinding
@@ -0,0 +1,250 @@
+#include "Core/Bidirectional.hpp"
+#include "SearchInternal.hpp"
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+/**
+ * Joins the two half paths: start .. meetForward from the forward parents,
+ * then meetBackward .. target from the backward ones (which point toward target).
+ * meetForward == meetBackward when the halves share a cell.
+ */
+void joinPaths(const SearchContext &forward, const SearchContext &backward, int meetForward, int meetBackward,
+               std::vector<int> &path) {
+    reconstructPath(forward, meetForward, path);
+    const int from = meetForward == meetBackward ? backward.parent(meetBackward) : meetBackward;
+    for (int at = from; at != -1; at = backward.parent(at))
+        path.push_back(at);
+}
+
+// The target side's open list: the same kind as the start side's, kept in its context
+BinaryHeap &sameKind(const BinaryHeap &, SearchContext &context, int) { return context.binaryHeap(); }
+QuaternaryHeap &sameKind(const QuaternaryHeap &, SearchContext &context, int) { return context.quaternaryHeap(); }
+RadixHeap &sameKind(const RadixHeap &, SearchContext &context, int) { return context.radixHeap(); }
+BucketQueue &sameKind(const BucketQueue &, SearchContext &context, int span) { return context.bucketQueue(span); }
+
+/**
+ * Bidirectional A*. Entering a cell costs grid.cost(cell), so the backward
+ * side pays the cost of the cell it leaves: its dist(cell) is the cost of
+ * the cells after cell up to and including target.
+ *
+ * Stopping rule: with consistent heuristics the smallest f on either open
+ * list is a lower bound on every path not found yet, so once a popped f
+ * reaches the best meeting cost mu, mu is optimal.
+ */
+template <typename OpenList, typename Counters>
+SearchResult biAStarWith(OpenList &openForward, OpenList &openBackward, Counters &counters, SearchContext &forward,
+                         SearchContext &backward, const GridMap &grid, int start, int target,
+                         SearchObserver *observer) {
+    SearchResult result;
+    const auto t0 = Clock::now();
+
+    forward.reset(grid.size());
+    backward.reset(grid.size());
+    const int hScale = grid.minCost();
+    forward.setDist(start, 0);
+    forward.setParent(start, -1);
+    backward.setDist(target, 0);
+    backward.setParent(target, -1);
+    const int h0 = manhattan(grid, start, target) * hScale;
+    openForward.push(h0, h0, start);
+    openBackward.push(h0, h0, target);
+    counters.counted(2, 0, 2);
+
+    int mu = start == target ? 0 : INF;
+    int meet = start == target ? start : -1;
+
+    while (!openForward.empty() && !openBackward.empty()) {
+        if (observer && observer->shouldAbort()) { result.aborted = true; break; }
+        // Expand the side with the smaller open list
+        const bool isForward = openForward.size() <= openBackward.size();
+        const OpenEntry top = isForward ? openForward.pop() : openBackward.pop();
+        counters.popped();
+        if (top.f >= mu) break;
+        const int cur = top.cell;
+        SearchContext &side = isForward ? forward : backward;
+        if (side.closed(cur)) { counters.stale(); continue; }
+        side.setClosed(cur);
+
+        ++result.stats.nodesExpanded;
+        if (observer) {
+            if (isForward) observer->onVisit(cur);
+            else observer->onVisitBackward(cur);
+        }
+
+        if (isForward) {
+            const int g = forward.dist(cur);
+            forEachNeighbor(grid, cur, [&](int nb) {
+                const int tentative = g + grid.cost(nb);
+                if (tentative < forward.dist(nb)) {
+                    forward.setDist(nb, tentative);
+                    forward.setParent(nb, cur);
+                    const int h = manhattan(grid, nb, target) * hScale;
+                    openForward.push(tentative + h, h, nb);
+                    counters.pushed(openForward.size() + openBackward.size());
+                    ++result.stats.nodesGenerated;
+                }
+                if (backward.dist(nb) != INF && forward.dist(nb) + backward.dist(nb) < mu) {
+                    mu = forward.dist(nb) + backward.dist(nb);
+                    meet = nb;
+                }
+            });
+        } else {
+            const int tentative = backward.dist(cur) + grid.cost(cur);
+            forEachNeighbor(grid, cur, [&](int nb) {
+                if (tentative < backward.dist(nb)) {
+                    backward.setDist(nb, tentative);
+                    backward.setParent(nb, cur);
+                    const int h = manhattan(grid, nb, start) * hScale;
+                    openBackward.push(tentative + h, h, nb);
+                    counters.pushed(openForward.size() + openBackward.size());
+                    ++result.stats.nodesGenerated;
+                }
+                if (forward.dist(nb) != INF && forward.dist(nb) + backward.dist(nb) < mu) {
+                    mu = forward.dist(nb) + backward.dist(nb);
+                    meet = nb;
+                }
+            });
+        }
+    }
+
+    if (!result.aborted && meet != -1) {
+        const auto tPath = counters.pathStart();
+        joinPaths(forward, backward, meet, meet, result.path);
+        counters.pathBuilt(tPath);
+        counters.allocated(result.path.capacity() * sizeof(int));
+        result.found = true;
+        result.pathCost = mu;
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+/**
+ * Level-synchronous: a whole BFS layer of one side is expanded before the
+ * meeting check, so the shortest edge joining the two searches in that layer
+ * gives the shortest path (a single-cell check could stop one step too long).
+ * Each side appends its next layer to its own context's FIFO, so the cells
+ * from its head on are that side's frontier and count as the open list.
+ */
+template <typename Counters>
+SearchResult biBfsWith(Counters &counters, SearchContext &forward, SearchContext &backward, const GridMap &grid,
+                       int start, int target, SearchObserver *observer) {
+    SearchResult result;
+    const auto t0 = Clock::now();
+
+    forward.reset(grid.size());
+    backward.reset(grid.size());
+    std::vector<int> &queueForward = forward.queue();
+    std::vector<int> &queueBackward = backward.queue();
+    std::size_t headForward = 0, headBackward = 0; // first cell of each side's frontier
+    queueForward.push_back(start);
+    if (!grid.isWall(target)) queueBackward.push_back(target); // never entered, as in bfs()
+    forward.setDist(start, 0);
+    forward.setParent(start, -1);
+    backward.setDist(target, 0);
+    backward.setParent(target, -1);
+
+    int best = INF, meetForward = -1, meetBackward = -1;
+    if (start == target) { best = 0; meetForward = meetBackward = start; }
+    const std::size_t seeds = queueForward.size() + queueBackward.size();
+    counters.counted(std::int64_t(seeds), 0, seeds);
+
+    while (best == INF && headForward < queueForward.size() && headBackward < queueBackward.size()) {
+        const bool isForward = queueForward.size() - headForward <= queueBackward.size() - headBackward;
+        std::vector<int> &queue = isForward ? queueForward : queueBackward;
+        std::size_t &head = isForward ? headForward : headBackward;
+        const std::size_t otherOpen = isForward ? queueBackward.size() - headBackward
+                                                : queueForward.size() - headForward;
+        SearchContext &mine = isForward ? forward : backward;
+        const SearchContext &other = isForward ? backward : forward;
+
+        const std::size_t levelBegin = head, levelEnd = queue.size();
+        for (; head < levelEnd; ++head) {
+            if (observer && observer->shouldAbort()) { result.aborted = true; break; }
+            const int cur = queue[head];
+            counters.popped();
+            ++result.stats.nodesExpanded;
+            if (observer) {
+                if (isForward) observer->onVisit(cur);
+                else observer->onVisitBackward(cur);
+            }
+
+            const int d = mine.dist(cur);
+            forEachNeighbor(grid, cur, [&](int nb) {
+                if (other.dist(nb) != INF && d + 1 + other.dist(nb) < best) {
+                    best = d + 1 + other.dist(nb);
+                    meetForward = isForward ? cur : nb;
+                    meetBackward = isForward ? nb : cur;
+                }
+                if (mine.dist(nb) != INF) return;
+                mine.setDist(nb, d + 1);
+                mine.setParent(nb, cur);
+                queue.push_back(nb);
+                counters.pushed(otherOpen + queue.size() - levelBegin);
+                ++result.stats.nodesGenerated;
+            });
+        }
+        if (result.aborted) break;
+    }
+
+    if (!result.aborted && best != INF) {
+        const auto tPath = counters.pathStart();
+        joinPaths(forward, backward, meetForward, meetBackward, result.path);
+        counters.pathBuilt(tPath);
+        counters.allocated(result.path.capacity() * sizeof(int));
+        result.found = true;
+        result.pathCost = pathCostOf(grid, result.path);
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+} // namespace
+
+SearchResult bidirectionalBfs(const GridMap &grid, int start, int target, SearchContext &context,
+                              SearchObserver *observer, const SearchOptions &options) {
+    if (!validQuery(grid, start, target)) return SearchResult();
+    // FIFO queues, so only the counters are selected
+    return withCounters(options, [&](auto counters) {
+        counters.trackContext(context);
+        SearchResult result = biBfsWith(counters, context, context.backward(), grid, start, target, observer);
+        counters.settleContext(context);
+        counters.report(result.stats);
+        return result;
+    });
+}
+
+SearchResult bidirectionalAStar(const GridMap &grid, int start, int target, SearchContext &context,
+                                SearchObserver *observer, const SearchOptions &options) {
+    if (!validQuery(grid, start, target)) return SearchResult();
+    if (grid.isWall(target)) return SearchResult(); // never entered, as in aStar()
+    const int span = grid.maxCost() + grid.minCost() + 1;
+    return withCounters(options, [&](auto counters) {
+        SearchContext &backward = context.backward();
+        counters.trackContext(context);
+        SearchResult result = withOpenList(context, options, span, [&](auto &open) {
+            return biAStarWith(open, sameKind(open, backward, span), counters, context, backward, grid, start,
+                               target, observer);
+        });
+        counters.settleContext(context);
+        counters.report(result.stats);
+        return result;
+    });
+}
+
+// Callers without a context of their own share the thread's
+SearchResult bidirectionalBfs(const GridMap &grid, int start, int target, SearchObserver *observer,
+                              const SearchOptions &options) {
+    return bidirectionalBfs(grid, start, target, threadContext(), observer, options);
+}
+
+SearchResult bidirectionalAStar(const GridMap &grid, int start, int target, SearchObserver *observer,
+                                const SearchOptions &options) {
+    return bidirectionalAStar(grid, start, target, threadContext(), observer, options);
+}
+
+} // namespace pathfinding
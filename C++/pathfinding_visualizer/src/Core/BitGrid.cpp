@@ -0,0 +1,83 @@
+#include "Core/BitGrid.hpp"
+
+namespace pathfinding {
+
+namespace {
+
+std::uint64_t lowMask(int count) {
+    return count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+}
+
+// Sets bits c0..c1 of a padded row (column c is bit c + 64)
+void setRange(std::uint64_t *row, int c0, int c1) {
+    for (int c = c0; c <= c1;) {
+        const std::size_t bit = std::size_t(c + 64);
+        const int shift = int(bit & 63);
+        const int count = c1 - c + 1 < 64 - shift ? c1 - c + 1 : 64 - shift;
+        row[bit >> 6] |= lowMask(count) << shift;
+        c += count;
+    }
+}
+
+} // namespace
+
+/**
+ * Rows are copied from the GridMap's packed walls 64 cells at a time; the
+ * mirrored row reads the same cells backwards, one bit reversal per word.
+ */
+BitGrid::BitGrid(const GridMap &grid)
+    : m_rows(grid.rows()),
+      m_cols(grid.cols()),
+      m_stride((std::size_t(grid.cols()) + 63) / 64 + 3)
+{
+    const std::size_t total = m_stride * std::size_t(m_rows);
+    m_bits.assign(total, ~std::uint64_t(0));
+    m_mirrored.assign(total, ~std::uint64_t(0));
+
+    for (int r = 0; r < m_rows; ++r) {
+        std::uint64_t *east = m_bits.data() + std::size_t(r) * m_stride;
+        std::uint64_t *west = m_mirrored.data() + std::size_t(r) * m_stride;
+        const int base = r * m_cols;
+        for (int b = 0; b < m_cols; b += 64) {
+            const int count = m_cols - b < 64 ? m_cols - b : 64;
+            const std::uint64_t tail = ~lowMask(count); // past the row stays blocked
+            east[1 + b / 64] = (grid.wallWindow(base + b) & lowMask(count)) | tail;
+            const std::uint64_t backwards = grid.wallWindow(base + m_cols - b - count) & lowMask(count);
+            west[1 + b / 64] = (reverseBits64(backwards << (64 - count))) | tail;
+        }
+    }
+}
+
+std::int64_t BitGrid::floodFill(int r, int c, std::vector<Run> &runs) const {
+    if (blocked(r, c)) return 0;
+    std::vector<std::uint64_t> visited(m_bits.size(), 0);
+    std::vector<Run> seeds{{r, c, c}};
+    std::int64_t filled = 0;
+    while (!seeds.empty()) {
+        const Run seed = seeds.back();
+        seeds.pop_back();
+        std::uint64_t *seen = visited.data() + std::size_t(seed.row) * m_stride;
+        if ((window(visited, seed.row, seed.first) & 1u) != 0) continue;
+
+        const int first = seed.first - freeRunWest(seed.row, seed.first) + 1;
+        const int last = seed.first + freeRunEast(seed.row, seed.first) - 1;
+        setRange(seen, first, last);
+        runs.push_back({seed.row, first, last});
+        filled += last - first + 1;
+
+        for (const int next : {seed.row - 1, seed.row + 1}) {
+            if (next < 0 || next >= m_rows) continue;
+            for (int x = first; x <= last; x += 64) {
+                // Free and unvisited cells of the neighbor row under this run
+                std::uint64_t open = ~windowEast(next, x) & ~window(visited, next, x) & lowMask(last - x + 1);
+                while (open) {
+                    seeds.push_back({next, x + countTrailingZeros64(open), 0});
+                    open &= open + (open & (~open + 1)); // drop the lowest stretch of ones
+                }
+            }
+        }
+    }
+    return filled;
+}
+
+} // namespace pathfinding
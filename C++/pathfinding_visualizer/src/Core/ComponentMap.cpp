@@ -0,0 +1,313 @@
+#include "Core/ComponentMap.hpp"
+#include "Core/BitOps.hpp"
+#include "SearchInternal.hpp"
+
+#include <algorithm>
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+// Past this share of changed cells a full rebuild is cheaper than repairing
+constexpr int kRebuildDivisor = 8;
+// Labels retired by splits and merges pile up; rebuild once they outnumber the live ones this much
+constexpr std::size_t kLabelSlack = 4;
+
+struct LabeledRun {
+    int first;
+    int last;
+    int label;
+};
+
+// Walls of row cells c.. (bit i = cell c + i); cells past the row's end read as walls
+std::uint64_t rowWindow(const GridMap &grid, int rowBase, int c, int cols) {
+    std::uint64_t bits = grid.wallWindow(rowBase + c);
+    if (cols - c < 64) bits |= ~std::uint64_t(0) << (cols - c);
+    return bits;
+}
+
+} // namespace
+
+const ComponentMap::UpdateStats &ComponentMap::update(const GridMap &grid, bool diagonal, SearchObserver *observer) {
+    const auto t0 = Clock::now();
+    m_lastUpdate = UpdateStats();
+    if (grid.empty()) { clear(); return m_lastUpdate; }
+
+    const bool sameModel = !empty() && m_diagonal == diagonal;
+    if (sameModel && m_snapshot.sameVersion(grid)) {
+        m_lastUpdate.incremental = true;
+        return m_lastUpdate;
+    }
+
+    std::vector<int> changed;
+    if (sameModel && m_snapshot.sameShape(grid)
+        && m_root.size() <= kLabelSlack * std::size_t(m_componentCount) + 4096
+        && m_snapshot.diff(grid, std::size_t(grid.size()) / kRebuildDivisor, changed)) {
+        m_lastUpdate.incremental = true;
+        if (repair(grid, changed, observer)) {
+            m_snapshot.apply(grid, changed);
+        } else if (!m_lastUpdate.aborted) {
+            m_lastUpdate.incremental = false;
+            m_lastUpdate.cellsChanged = grid.size();
+            m_lastUpdate.aborted = !build(grid, observer);
+        }
+    } else {
+        m_diagonal = diagonal;
+        m_lastUpdate.cellsChanged = grid.size();
+        m_lastUpdate.aborted = !build(grid, observer);
+    }
+    if (m_lastUpdate.aborted) clear();
+    m_lastUpdate.elapsedMs = elapsedSince(t0);
+    return m_lastUpdate;
+}
+
+void ComponentMap::clear() {
+    m_rows = m_cols = 0;
+    m_componentCount = 0;
+    m_label.clear();
+    m_root.clear();
+    m_snapshot.clear();
+}
+
+std::size_t ComponentMap::memoryBytes() const {
+    return (m_label.capacity() + m_root.capacity()) * sizeof(int);
+}
+
+int ComponentMap::newLabel() {
+    m_root.push_back(int(m_root.size()));
+    return int(m_root.size()) - 1;
+}
+
+int ComponentMap::find(int label) {
+    int root = label;
+    while (m_root[std::size_t(root)] != root) root = m_root[std::size_t(root)];
+    while (m_root[std::size_t(label)] != root) {
+        const int next = m_root[std::size_t(label)];
+        m_root[std::size_t(label)] = root;
+        label = next;
+    }
+    return root;
+}
+
+/**
+ * Every free run of a row gets a label that is unioned with the runs of the
+ * row above it overlaps (or touches diagonally). Runs are found by bit scans
+ * over the packed walls. A final pass renumbers the roots to 0..n-1 so every
+ * cell holds its region id and the parent array starts out flat.
+ */
+bool ComponentMap::build(const GridMap &grid, SearchObserver *observer) {
+    m_rows = grid.rows();
+    m_cols = grid.cols();
+    // Grown row by row inside the reserved block, so even first-touching the pages of a huge label array can be cancelled
+    m_label.clear();
+    m_label.reserve(std::size_t(grid.size()));
+    m_root.clear();
+
+    const int reach = m_diagonal ? 1 : 0;
+    std::vector<LabeledRun> above, current;
+    for (int r = 0; r < m_rows; ++r) {
+        if (observer && observer->shouldAbort()) return false;
+        current.clear();
+        const int base = r * m_cols;
+        m_label.resize(std::size_t(base) + std::size_t(m_cols), -1);
+        std::size_t j = 0; // first run above that can still overlap
+        for (int c = 0; c < m_cols;) {
+            const std::uint64_t walls = rowWindow(grid, base, c, m_cols);
+            if (walls == ~std::uint64_t(0)) { c += 64; continue; }
+            const int first = c + countTrailingZeros64(~walls);
+            int last = first;
+            for (;;) {
+                const std::uint64_t ahead = rowWindow(grid, base, last, m_cols);
+                if (ahead != 0) { last += countTrailingZeros64(ahead) - 1; break; }
+                last += 64;
+            }
+
+            const int label = newLabel();
+            while (j < above.size() && above[j].last < first - reach) ++j;
+            for (std::size_t k = j; k < above.size() && above[k].first <= last + reach; ++k) {
+                const int a = find(label), b = find(above[k].label);
+                if (a != b) m_root[std::size_t(std::max(a, b))] = std::min(a, b);
+            }
+            std::fill(m_label.begin() + base + first, m_label.begin() + base + last + 1, label);
+            current.push_back({first, last, label});
+            c = last + 1;
+        }
+        above.swap(current);
+    }
+
+    std::vector<int> id(m_root.size(), -1);
+    m_componentCount = 0;
+    for (std::size_t i = 0; i < m_root.size(); ++i) {
+        const int root = find(int(i));
+        if (id[std::size_t(root)] < 0) id[std::size_t(root)] = m_componentCount++;
+        id[i] = id[std::size_t(root)];
+    }
+    for (int r = 0; r < m_rows; ++r) {
+        if (observer && observer->shouldAbort()) return false;
+        const auto row = m_label.begin() + std::ptrdiff_t(r) * m_cols;
+        for (auto it = row; it != row + m_cols; ++it)
+            if (*it >= 0) *it = id[std::size_t(*it)];
+    }
+    m_root.resize(std::size_t(m_componentCount));
+    for (int i = 0; i < m_componentCount; ++i) m_root[std::size_t(i)] = i;
+    m_snapshot.assign(grid);
+    return true;
+}
+
+/**
+ * Ring order N, NE, E, SE, S, SW, W, NW: neighbors on the ring always touch,
+ * and with diagonal links two edge cells around a corner touch as well.
+ * Out-of-bounds cells are blocked.
+ */
+template <typename Blocked>
+int ComponentMap::ringGroups(int cell, Blocked &&blocked) const {
+    static constexpr int kRing[8][2] = {{-1, 0}, {-1, 1}, {0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}};
+    const int r = cell / m_cols, c = cell - r * m_cols;
+    bool open[8];
+    int group[8];
+    for (int i = 0; i < 8; ++i) {
+        const int rr = r + kRing[i][0], cc = c + kRing[i][1];
+        open[i] = rr >= 0 && rr < m_rows && cc >= 0 && cc < m_cols && !blocked(rr * m_cols + cc);
+        group[i] = i;
+    }
+    auto root = [&](int i) { while (group[i] != i) i = group[i]; return i; };
+    auto join = [&](int a, int b) { if (open[a] && open[b]) group[root(a)] = root(b); };
+    for (int i = 0; i < 8; ++i) join(i, (i + 1) % 8);
+    if (m_diagonal)
+        for (int i = 0; i < 8; i += 2) join(i, (i + 2) % 8);
+
+    // Without diagonal links a group only counts if it holds an edge cell
+    bool counted[8] = {};
+    int groups = 0;
+    for (int i = 0; i < 8; ++i) {
+        if (!open[i] || (!m_diagonal && i % 2 != 0)) continue;
+        const int g = root(i);
+        if (!counted[g]) { counted[g] = true; ++groups; }
+    }
+    return groups;
+}
+
+/**
+ * New walls are taken one at a time, with the freed cells still blocked and
+ * the later walls still open. A wall whose ring forms one group leaves its
+ * region connected; one with no group was the region's last cell; otherwise
+ * the region may have split, and every free neighbor of its new walls floods
+ * its part with a fresh label (picking up any freed cells on the way).
+ * Freed cells left over start their own label and are unioned with their
+ * neighbors. Regions whose cells were overwritten or that lost their last
+ * cell are no longer counted.
+ */
+bool ComponentMap::repair(const GridMap &grid, const std::vector<int> &changed, SearchObserver *observer) {
+    const int firstNew = int(m_root.size());
+    std::vector<int> walled, freed, splitRoots, deadRoots;
+    for (int cell : changed) {
+        const bool wall = grid.isWall(cell);
+        if (wall == (m_snapshot.cell(cell) == GridMap::Wall)) continue; // cost edit
+        (wall ? walled : freed).push_back(cell);
+    }
+    m_lastUpdate.cellsChanged = std::int64_t(walled.size() + freed.size());
+
+    std::vector<int> removed; // walls already taken, sorted
+    std::vector<int> regions; // old region of each new wall
+    for (int cell : walled) {
+        const int region = component(cell);
+        const int groups = ringGroups(cell, [&](int nb) {
+            return m_snapshot.cell(nb) == GridMap::Wall || std::binary_search(removed.begin(), removed.end(), nb);
+        });
+        if (groups == 0) deadRoots.push_back(region);
+        else if (groups > 1) splitRoots.push_back(region);
+        regions.push_back(region);
+        removed.insert(std::upper_bound(removed.begin(), removed.end(), cell), cell);
+    }
+    for (int cell : walled) m_label[std::size_t(cell)] = -1;
+    std::sort(splitRoots.begin(), splitRoots.end());
+
+    int created = 0;
+    std::int64_t budget = std::int64_t(grid.size()) / kRebuildDivisor;
+    for (std::size_t i = 0; i < walled.size(); ++i) {
+        if (!std::binary_search(splitRoots.begin(), splitRoots.end(), regions[i])) continue;
+        bool overBudget = false;
+        forEachLinked(walled[i], [&](int nb) {
+            if (overBudget || grid.isWall(nb) || m_label[std::size_t(nb)] >= firstNew) return;
+            const std::int64_t labeled = relabel(grid, nb, newLabel(), firstNew, budget, deadRoots, observer);
+            if (labeled < 0) { overBudget = true; return; }
+            budget -= labeled;
+            m_lastUpdate.cellsRelabeled += labeled;
+            ++created;
+        });
+        if (overBudget) {
+            m_lastUpdate.aborted = observer && observer->shouldAbort();
+            return false;
+        }
+    }
+    deadRoots.insert(deadRoots.end(), splitRoots.begin(), splitRoots.end());
+
+    for (int cell : freed) {
+        if (m_label[std::size_t(cell)] >= 0) continue; // reached by a flood
+        const int label = newLabel();
+        m_label[std::size_t(cell)] = label;
+        ++created;
+        forEachLinked(cell, [&](int nb) {
+            const int other = m_label[std::size_t(nb)];
+            if (other < 0) return;
+            const int a = find(label), b = find(other);
+            if (a == b) return;
+            m_root[std::size_t(std::max(a, b))] = std::min(a, b);
+            --created;
+        });
+    }
+
+    std::sort(deadRoots.begin(), deadRoots.end());
+    deadRoots.erase(std::unique(deadRoots.begin(), deadRoots.end()), deadRoots.end());
+    m_componentCount += created - int(deadRoots.size());
+    for (std::size_t i = 0; i < m_root.size(); ++i) m_root[i] = find(int(i));
+    return true;
+}
+
+std::int64_t ComponentMap::relabel(const GridMap &grid, int seed, int label, int firstNew, std::int64_t budget,
+                                   std::vector<int> &deadRoots, SearchObserver *observer) {
+    std::int64_t visited = 0;
+    std::vector<int> stack{seed};
+    auto claim = [&](int cell) {
+        const int old = m_label[std::size_t(cell)];
+        // Old labels are flat after the last update, so m_root gives the region directly
+        if (old >= 0 && (deadRoots.empty() || deadRoots.back() != m_root[std::size_t(old)]))
+            deadRoots.push_back(m_root[std::size_t(old)]);
+        m_label[std::size_t(cell)] = label;
+    };
+    claim(seed);
+    while (!stack.empty()) {
+        if (++visited > budget) return -1;
+        if ((visited & 4095) == 0 && observer && observer->shouldAbort()) return -1;
+        const int cell = stack.back();
+        stack.pop_back();
+        forEachLinked(cell, [&](int nb) {
+            if (grid.isWall(nb) || m_label[std::size_t(nb)] >= firstNew) return;
+            claim(nb);
+            stack.push_back(nb);
+        });
+    }
+    return visited;
+}
+
+bool ComponentMap::reachable(int start, int target) const {
+    if (start == target) return true;
+    const int goal = component(target);
+    if (goal < 0) return false;
+    if (m_label[std::size_t(start)] >= 0) return component(start) == goal;
+    bool linked = false;
+    forEachLinked(start, [&](int nb) { linked = linked || component(nb) == goal; });
+    return linked;
+}
+
+const ComponentMap &componentsFor(const GridMap &grid, const SearchOptions &options, SearchObserver *observer) {
+    thread_local ComponentMap components;
+    const bool diagonal = options.connectivity == Connectivity::Eight && options.corners == CornerCutting::Always;
+    if (components.empty() || components.version() != grid.version() || components.diagonal() != diagonal)
+        components.update(grid, diagonal, observer);
+    return components;
+}
+
+} // namespace pathfinding
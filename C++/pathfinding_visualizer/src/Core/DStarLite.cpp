@@ -0,0 +1,230 @@
+#include "Core/DStarLite.hpp"
+#include "SearchInternal.hpp"
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+// Past this share of changed cells starting over is cheaper than repairing
+constexpr int kRebuildDivisor = 8;
+
+} // namespace
+
+void DStarLite::clear() {
+    m_goal = m_start = m_last = -1;
+    m_km = 0;
+    m_g.clear();
+    m_rhs.clear();
+    m_key.clear();
+    m_open.clear();
+    m_heap.clear();
+    m_snapshot.clear();
+}
+
+SearchResult DStarLite::plan(const GridMap &grid, int start, int target, SearchObserver *observer) {
+    const auto t0 = Clock::now();
+    SearchResult result;
+    m_lastPlan = PlanStats();
+    if (!validQuery(grid, start, target)) { clear(); return result; }
+
+    std::vector<int> changed;
+    const bool reuse = valid() && target == m_goal && m_snapshot.sameShape(grid)
+        && grid.minCost() >= m_hScale
+        && (m_snapshot.sameVersion(grid)
+            || m_snapshot.diff(grid, std::size_t(grid.size()) / kRebuildDivisor, changed));
+    if (reuse) {
+        m_lastPlan.incremental = true;
+        m_lastPlan.cellsChanged = std::int64_t(changed.size());
+        if (start != m_start) {
+            m_km += heuristic(m_last, start);
+            m_last = start;
+            const int previous = m_start;
+            m_start = start;
+            // Only the start may be a wall and still have successors
+            updateVertex(grid, previous);
+            updateVertex(grid, start);
+        }
+        // Entering a changed cell costs something else now: re-evaluate the
+        // cell itself and every neighbor with an edge into it
+        for (int cell : changed) {
+            updateVertex(grid, cell);
+            const int r = grid.rowOf(cell), c = grid.colOf(cell);
+            if (r + 1 < grid.rows()) updateVertex(grid, cell + grid.cols());
+            if (r > 0) updateVertex(grid, cell - grid.cols());
+            if (c + 1 < grid.cols()) updateVertex(grid, cell + 1);
+            if (c > 0) updateVertex(grid, cell - 1);
+        }
+        if (!changed.empty()) m_snapshot.apply(grid, changed);
+    } else {
+        initialize(grid, start, target);
+    }
+
+    computeShortestPath(grid, observer);
+    result.stats.nodesExpanded = m_lastPlan.expanded;
+    if (m_lastPlan.aborted) {
+        result.aborted = true;
+    } else {
+        const auto tPath = Clock::now();
+        if (extractPath(grid, result.path)) {
+            result.found = true;
+            result.pathCost = m_g[std::size_t(start)];
+        }
+        m_lastPlan.pathMs = elapsedSince(tPath);
+    }
+    m_lastPlan.elapsedMs = elapsedSince(t0);
+    result.stats.elapsedMs = m_lastPlan.elapsedMs;
+    return result;
+}
+
+void DStarLite::initialize(const GridMap &grid, int start, int target) {
+    const std::size_t n = std::size_t(grid.size());
+    m_goal = target;
+    m_start = m_last = start;
+    m_km = 0;
+    m_hScale = grid.minCost();
+    m_g.assign(n, INF);
+    m_rhs.assign(n, INF);
+    m_key.assign(n, Key{INF, INF});
+    m_open.assign(n, 0);
+    m_heap.clear();
+    m_snapshot.assign(grid);
+
+    m_rhs[std::size_t(target)] = 0;
+    push(target, calculateKey(target));
+}
+
+int DStarLite::heuristic(int a, int b) const {
+    const int cols = m_snapshot.cols();
+    return (std::abs(a / cols - b / cols) + std::abs(a % cols - b % cols)) * m_hScale;
+}
+
+DStarLite::Key DStarLite::calculateKey(int cell) const {
+    const int best = std::min(m_g[std::size_t(cell)], m_rhs[std::size_t(cell)]);
+    if (best == INF) return Key{INF, INF};
+    return Key{best + heuristic(m_start, cell) + m_km, best};
+}
+
+// rhs: best one-step lookahead through the free neighbors (walls are never entered)
+int DStarLite::lookahead(const GridMap &grid, int cell) const {
+    if (grid.isWall(cell) && cell != m_start) return INF;
+    int best = INF;
+    forEachNeighbor(grid, cell, [&](int nb) {
+        const int g = m_g[std::size_t(nb)];
+        if (g != INF) best = std::min(best, g + grid.cost(nb));
+    });
+    return best;
+}
+
+void DStarLite::updateVertex(const GridMap &grid, int cell) {
+    if (cell != m_goal) m_rhs[std::size_t(cell)] = lookahead(grid, cell);
+    if (m_g[std::size_t(cell)] != m_rhs[std::size_t(cell)]) push(cell, calculateKey(cell));
+    else m_open[std::size_t(cell)] = 0;
+}
+
+/**
+ * Entries are never removed in place: a pushed key supersedes older entries
+ * of the same cell, and topKey() drops whatever no longer matches.
+ */
+void DStarLite::push(int cell, Key key) {
+    if (m_open[std::size_t(cell)] && m_key[std::size_t(cell)] == key) return;
+    m_open[std::size_t(cell)] = 1;
+    m_key[std::size_t(cell)] = key;
+    const auto later = [](const Entry &a, const Entry &b) { return b.key < a.key; };
+    m_heap.push_back(Entry{key, cell});
+    std::push_heap(m_heap.begin(), m_heap.end(), later);
+
+    // Long replanning sessions pile up stale entries; squeeze them out now and then
+    if (m_heap.size() > 2 * m_g.size() + 1024) {
+        m_heap.erase(std::remove_if(m_heap.begin(), m_heap.end(), [&](const Entry &e) {
+            return !m_open[std::size_t(e.cell)] || !(m_key[std::size_t(e.cell)] == e.key);
+        }), m_heap.end());
+        std::make_heap(m_heap.begin(), m_heap.end(), later);
+    }
+}
+
+bool DStarLite::topKey(Key &key) {
+    const auto later = [](const Entry &a, const Entry &b) { return b.key < a.key; };
+    while (!m_heap.empty()) {
+        const Entry &top = m_heap.front();
+        if (m_open[std::size_t(top.cell)] && m_key[std::size_t(top.cell)] == top.key) {
+            key = top.key;
+            return true;
+        }
+        std::pop_heap(m_heap.begin(), m_heap.end(), later);
+        m_heap.pop_back();
+    }
+    return false;
+}
+
+void DStarLite::computeShortestPath(const GridMap &grid, SearchObserver *observer) {
+    const auto later = [](const Entry &a, const Entry &b) { return b.key < a.key; };
+    const std::size_t s = std::size_t(m_start);
+    Key top;
+    while (topKey(top) && (top < calculateKey(m_start) || m_rhs[s] != m_g[s])) {
+        if (observer && observer->shouldAbort()) { m_lastPlan.aborted = true; return; }
+        const int u = m_heap.front().cell;
+        std::pop_heap(m_heap.begin(), m_heap.end(), later);
+        m_heap.pop_back();
+        m_open[std::size_t(u)] = 0;
+
+        const Key fresh = calculateKey(u);
+        if (top < fresh) { // the start moved since u was queued
+            push(u, fresh);
+            continue;
+        }
+        ++m_lastPlan.expanded;
+        if (observer) observer->onVisit(u);
+
+        const int cols = grid.cols();
+        const int r = u / cols, c = u - r * cols;
+        auto updateNeighbors = [&] {
+            if (r + 1 < grid.rows()) updateVertex(grid, u + cols);
+            if (r > 0) updateVertex(grid, u - cols);
+            if (c + 1 < cols) updateVertex(grid, u + 1);
+            if (c > 0) updateVertex(grid, u - 1);
+        };
+        if (m_g[std::size_t(u)] > m_rhs[std::size_t(u)]) {
+            m_g[std::size_t(u)] = m_rhs[std::size_t(u)];
+            updateNeighbors();
+        } else {
+            m_g[std::size_t(u)] = INF;
+            updateNeighbors();
+            updateVertex(grid, u);
+        }
+    }
+}
+
+// Greedy descent over g; after computeShortestPath() it follows a shortest path
+bool DStarLite::extractPath(const GridMap &grid, std::vector<int> &path) const {
+    path.clear();
+    if (m_rhs[std::size_t(m_start)] == INF) return false;
+    int at = m_start;
+    path.push_back(at);
+    while (at != m_goal) {
+        int best = INF, bestNext = -1;
+        forEachNeighbor(grid, at, [&](int nb) {
+            const int g = m_g[std::size_t(nb)];
+            if (g != INF && g + grid.cost(nb) < best) { best = g + grid.cost(nb); bestNext = nb; }
+        });
+        if (bestNext == -1 || int(path.size()) > grid.size()) { path.clear(); return false; }
+        at = bestNext;
+        path.push_back(at);
+    }
+    return true;
+}
+
+SearchResult dStarLiteSearch(const GridMap &grid, int start, int target, SearchObserver *observer,
+                             const SearchOptions &options) {
+    // Keys are pairs, so the planner keeps its own heap; its counters only split the time
+    thread_local DStarLite planner;
+    return withCounters(options, [&](auto counters) {
+        SearchResult result = planner.plan(grid, start, target, observer);
+        counters.pathTook(planner.lastPlan().pathMs);
+        counters.report(result.stats);
+        return result;
+    });
+}
+
+} // namespace pathfinding
@@ -0,0 +1,221 @@
+#include "Core/FlowField.hpp"
+#include "SearchInternal.hpp"
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+// Past this share of changed cells a full rebuild is cheaper than repairing
+constexpr int kRebuildDivisor = 8;
+
+/**
+ * Settles cells in cost order. Entering cell v costs grid.cost(v), so in
+ * reverse a cell u next to v gets dist[v] + cost(v). Seeds may come in with
+ * any distance; the radix heap only needs pushes not below the last pop.
+ */
+std::int64_t propagate(const GridMap &grid, RadixHeap &open, std::vector<int> &dist, std::vector<int> &next,
+                       SearchObserver *observer, bool &aborted) {
+    std::int64_t settled = 0;
+    while (!open.empty()) {
+        if (observer && observer->shouldAbort()) { aborted = true; break; }
+        const OpenEntry top = open.pop();
+        const int cur = top.cell;
+        if (top.f != dist[cur]) continue;
+        ++settled;
+        if (observer) observer->onVisit(cur);
+
+        const int through = dist[cur] + grid.cost(cur);
+        forEachNeighbor(grid, cur, [&](int nb) {
+            if (through < dist[nb]) {
+                dist[nb] = through;
+                next[nb] = cur;
+                open.push(through, 0, nb);
+            }
+        });
+    }
+    return settled;
+}
+
+} // namespace
+
+void FlowField::clear() {
+    m_target = -1;
+    m_dist.clear();
+    m_next.clear();
+    m_snapshot.clear();
+}
+
+const FlowField::UpdateStats &FlowField::update(const GridMap &grid, int target, SearchObserver *observer) {
+    const auto t0 = Clock::now();
+    m_lastUpdate = UpdateStats();
+    if (!validQuery(grid, target, target)) { clear(); return m_lastUpdate; }
+    if (valid() && target == m_target && m_snapshot.sameVersion(grid)) return m_lastUpdate;
+
+    std::vector<int> changed;
+    if (valid() && target == m_target && m_snapshot.sameShape(grid)
+        && m_snapshot.diff(grid, std::size_t(grid.size()) / kRebuildDivisor, changed)
+        && !std::binary_search(changed.begin(), changed.end(), target)) {
+        m_lastUpdate.incremental = true;
+        m_lastUpdate.cellsChanged = std::int64_t(changed.size());
+        if (!changed.empty()) repair(grid, changed, observer);
+        m_snapshot.apply(grid, changed);
+    }
+    if (!m_lastUpdate.incremental) {
+        rebuild(grid, target, observer);
+        m_lastUpdate.cellsChanged = std::int64_t(grid.size());
+    }
+    // A half-settled field is useless; start over next time
+    if (m_lastUpdate.aborted) clear();
+    m_lastUpdate.elapsedMs = elapsedSince(t0);
+    return m_lastUpdate;
+}
+
+void FlowField::rebuild(const GridMap &grid, int target, SearchObserver *observer) {
+    m_target = target;
+    m_dist.assign(std::size_t(grid.size()), INF);
+    m_next.assign(std::size_t(grid.size()), -1);
+
+    // A wall target is never entered, so nothing reaches it
+    if (!grid.isWall(target)) {
+        RadixHeap open;
+        m_dist[target] = 0;
+        open.push(0, 0, target);
+        m_lastUpdate.cellsRecomputed = propagate(grid, open, m_dist, m_next, observer, m_lastUpdate.aborted);
+    }
+    m_snapshot.assign(grid);
+}
+
+/**
+ * 1. Invalidate: cells whose next-chain passes through a cell that became
+ *    a wall or more expensive lose their distance (the subtree below that
+ *    cell in the next-pointer tree; a new wall loses its own as well).
+ * 2. Seed: invalidated cells, changed cells and their neighbors take the best
+ *    value offered by a still-valid neighbor.
+ * 3. Propagate from the seeds, which also carries any decreases outward.
+ */
+void FlowField::repair(const GridMap &grid, const std::vector<int> &changed, SearchObserver *observer) {
+    std::vector<int> invalid;
+    std::vector<int> stack;
+    for (int w : changed) {
+        const bool nowWall = grid.isWall(w);
+        const bool dearer = !nowWall && grid.cost(w) > m_snapshot.cost(w);
+        if (!nowWall && !dearer) continue;
+        if (m_dist[w] == INF) continue; // nothing routes through an unreachable cell
+        stack.push_back(w);
+        while (!stack.empty()) {
+            const int x = stack.back();
+            stack.pop_back();
+            const int r = grid.rowOf(x), c = grid.colOf(x);
+            const int around[4][2] = {{r + 1, c}, {r - 1, c}, {r, c + 1}, {r, c - 1}};
+            for (const auto &rc : around) {
+                if (!grid.inBounds(rc[0], rc[1])) continue;
+                const int child = grid.index(rc[0], rc[1]);
+                if (m_next[child] != x || m_dist[child] == INF) continue;
+                m_dist[child] = INF;
+                m_next[child] = -1;
+                invalid.push_back(child);
+                stack.push_back(child);
+            }
+        }
+        if (nowWall) {
+            m_dist[w] = INF;
+            m_next[w] = -1;
+        }
+    }
+
+    RadixHeap open;
+    auto seed = [&](int cell) {
+        if (grid.isWall(cell) || cell == m_target) return;
+        int best = m_dist[cell], bestNext = m_next[cell];
+        forEachNeighbor(grid, cell, [&](int nb) {
+            if (m_dist[nb] == INF) return;
+            const int through = m_dist[nb] + grid.cost(nb);
+            if (through < best) { best = through; bestNext = nb; }
+        });
+        if (best == INF) return;
+        m_dist[cell] = best;
+        m_next[cell] = bestNext;
+        open.push(best, 0, cell);
+    };
+    // Valid neighbors of a cheaper cell must also re-push it, so seed them all
+    for (int cell : invalid) seed(cell);
+    for (int w : changed) {
+        seed(w);
+        forEachNeighbor(grid, w, [&](int nb) { seed(nb); });
+    }
+    m_lastUpdate.cellsRecomputed = propagate(grid, open, m_dist, m_next, observer, m_lastUpdate.aborted);
+}
+
+int FlowField::distance(int cell) const {
+    const int d = m_dist[std::size_t(cell)];
+    return d == INF ? Unreachable : d;
+}
+
+int FlowField::maxDistance() const {
+    int best = 0;
+    for (int d : m_dist)
+        if (d != INF && d > best) best = d;
+    return best;
+}
+
+SearchResult FlowField::query(int start) const {
+    SearchResult result;
+    if (!valid() || start < 0 || start >= int(m_dist.size())) return result;
+    const auto t0 = Clock::now();
+
+    int at = start;
+    int cost = m_dist[std::size_t(start)];
+    if (m_snapshot.cell(start) == GridMap::Wall && start != m_target) {
+        // Searches may leave a wall start (never enter one): step to the best neighbor first
+        const int rows = m_snapshot.rows(), cols = m_snapshot.cols();
+        const int r = start / cols, c = start % cols;
+        const int around[4][2] = {{r + 1, c}, {r - 1, c}, {r, c + 1}, {r, c - 1}};
+        at = -1;
+        cost = INF;
+        for (const auto &rc : around) {
+            if (rc[0] < 0 || rc[0] >= rows || rc[1] < 0 || rc[1] >= cols) continue;
+            const int nb = rc[0] * cols + rc[1];
+            if (m_dist[std::size_t(nb)] == INF) continue;
+            const int through = m_dist[std::size_t(nb)] + m_snapshot.cost(nb);
+            if (through < cost) { cost = through; at = nb; }
+        }
+        if (at == -1) { result.stats.elapsedMs = elapsedSince(t0); return result; }
+        result.path.push_back(start);
+    }
+    if (m_dist[std::size_t(at)] == INF) { result.stats.elapsedMs = elapsedSince(t0); return result; }
+
+    for (; at != -1; at = m_next[std::size_t(at)])
+        result.path.push_back(at);
+    result.found = true;
+    result.pathCost = cost;
+    result.stats.nodesExpanded = std::int64_t(result.path.size());
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+SearchResult flowFieldSearch(const GridMap &grid, int start, int target, SearchObserver *observer,
+                             const SearchOptions &options) {
+    // The field always uses the radix heap, and its counters only split the time
+    if (!validQuery(grid, start, target)) return SearchResult();
+    thread_local FlowField field;
+    const auto t0 = Clock::now();
+    const FlowField::UpdateStats &updated = field.update(grid, target, observer);
+    if (updated.aborted) {
+        SearchResult aborted;
+        aborted.aborted = true;
+        return aborted;
+    }
+    SearchResult result = field.query(start);
+    const double walkMs = result.stats.elapsedMs; // following the field is the path reconstruction
+    result.stats.nodesExpanded = updated.cellsRecomputed;
+    result.stats.elapsedMs = elapsedSince(t0);
+    return withCounters(options, [&](auto counters) {
+        counters.pathTook(walkMs);
+        counters.report(result.stats);
+        return result;
+    });
+}
+
+} // namespace pathfinding
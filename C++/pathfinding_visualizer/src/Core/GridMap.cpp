@@ -0,0 +1,111 @@
+#include "Core/GridMap.hpp"
+#include "Core/BitOps.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace pathfinding {
+
+namespace {
+
+std::atomic<std::uint64_t> g_nextVersion{1};
+
+} // namespace
+
+GridMap::GridMap(int rows, int cols, std::uint8_t fill)
+    : m_rows(rows > 0 ? rows : 0),
+      m_cols(cols > 0 ? cols : 0),
+      m_walls((static_cast<std::size_t>(m_rows) * static_cast<std::size_t>(m_cols) + 63) / 64, 0)
+{
+    if (fill != Free) this->fill(fill);
+}
+
+void GridMap::fill(std::uint8_t value) {
+    std::fill(m_walls.begin(), m_walls.end(), value != Free ? ~std::uint64_t(0) : 0);
+    // Keep the bits past the last cell clear so wallCount() can popcount whole words
+    const int tail = size() & 63;
+    if (tail != 0 && !m_walls.empty()) m_walls.back() &= (std::uint64_t(1) << tail) - 1;
+    touch();
+}
+
+std::uint64_t GridMap::wallWindow(int idx) const {
+    const std::size_t n = std::size_t(size());
+    const std::size_t at = std::size_t(idx);
+    if (at >= n) return ~std::uint64_t(0);
+    const std::size_t w = at >> 6;
+    const unsigned shift = unsigned(at & 63);
+    std::uint64_t bits = m_walls[w] >> shift;
+    if (shift != 0 && w + 1 < m_walls.size()) bits |= m_walls[w + 1] << (64 - shift);
+    if (at + 64 > n) bits |= ~std::uint64_t(0) << (n - at); // past the end
+    return bits;
+}
+
+void GridMap::setWalls(int idx, std::uint64_t bits, int count) {
+    if (count <= 0) return;
+    const std::uint64_t mask = count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+    bits &= mask;
+    const std::size_t at = std::size_t(idx);
+    const std::size_t w = at >> 6;
+    const unsigned shift = unsigned(at & 63);
+    m_walls[w] = (m_walls[w] & ~(mask << shift)) | (bits << shift);
+    if (shift != 0 && shift + unsigned(count) > 64)
+        m_walls[w + 1] = (m_walls[w + 1] & ~(mask >> (64 - shift))) | (bits >> (64 - shift));
+    touch();
+}
+
+std::int64_t GridMap::wallCount() const {
+    std::int64_t walls = 0;
+    for (std::uint64_t word : m_walls) walls += popcount64(word);
+    return walls;
+}
+
+std::uint64_t GridMap::nextVersion() {
+    return g_nextVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GridMap::setCost(int idx, std::uint8_t cost) {
+    if (cost == 0) cost = UnitCost;
+    if (m_costs.empty()) {
+        if (cost == UnitCost) return;
+        m_costs.assign(std::size_t(size()), UnitCost);
+        m_costCount.assign(256, 0);
+        m_costCount[UnitCost] = static_cast<std::uint32_t>(size());
+    }
+    --m_costCount[m_costs[idx]];
+    ++m_costCount[cost];
+    m_costs[idx] = cost;
+    touch();
+}
+
+void GridMap::setCosts(const std::uint8_t *costs) {
+    m_costs.assign(costs, costs + size());
+    m_costCount.assign(256, 0);
+    for (std::uint8_t &c : m_costs) {
+        if (c == 0) c = UnitCost;
+        ++m_costCount[c];
+    }
+    touch();
+}
+
+void GridMap::clearCosts() {
+    m_costs.clear();
+    m_costs.shrink_to_fit();
+    m_costCount.clear();
+    touch();
+}
+
+int GridMap::minCost() const {
+    if (m_costs.empty()) return UnitCost;
+    for (int c = 1; c < 256; ++c)
+        if (m_costCount[c] != 0) return c;
+    return UnitCost;
+}
+
+int GridMap::maxCost() const {
+    if (m_costs.empty()) return UnitCost;
+    for (int c = 255; c > 0; --c)
+        if (m_costCount[c] != 0) return c;
+    return UnitCost;
+}
+
+} // namespace pathfinding
@@ -0,0 +1,452 @@
+#include "Core/HierarchicalGraph.hpp"
+#include "SearchInternal.hpp"
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+// Past this share of changed cells rebuilding everything is cheaper
+constexpr int kRebuildDivisor = 8;
+// Border runs at least this long get an entrance at each end instead of one in the middle
+constexpr int kLongEntrance = 6;
+
+/**
+ * Dijkstra confined to the cells of one cluster. load() copies the
+ * cluster's walls and costs into local arrays once, so the searches from
+ * every entrance never touch the full map; clusters without costs run a
+ * plain BFS. Forward runs give the cost of reaching each cell from source,
+ * reverse runs the cost of reaching source from each cell.
+ */
+class LocalSearch {
+public:
+    void load(const GridMap &grid, int r0, int c0, int r1, int c1) {
+        m_cols = grid.cols();
+        m_r0 = r0;
+        m_c0 = c0;
+        m_w = c1 - c0;
+        m_h = r1 - r0;
+        const std::size_t n = std::size_t(m_w) * std::size_t(m_h);
+        m_wall.resize(n);
+        m_cost.resize(n);
+        m_uniform = true;
+        for (int r = 0; r < m_h; ++r) {
+            for (int c = 0; c < m_w; ++c) {
+                const int cell = grid.index(r0 + r, c0 + c);
+                const std::size_t l = std::size_t(r * m_w + c);
+                m_wall[l] = grid.isWall(cell);
+                m_cost[l] = grid.cost(cell);
+                m_uniform = m_uniform && m_cost[l] == m_cost[0];
+            }
+        }
+    }
+
+    void run(int source, bool reverse, int stopAt = -1) {
+        m_dist.assign(m_wall.size(), INF);
+        m_parent.assign(m_wall.size(), -1);
+        const int from = local(source);
+        // Nothing can enter a wall, so a reverse run from one reaches nothing
+        if (reverse && m_wall[std::size_t(from)]) return;
+        const int stop = stopAt < 0 ? -1 : local(stopAt);
+        m_dist[std::size_t(from)] = 0;
+        if (m_uniform) runBfs(from, stop);
+        else runDijkstra(from, reverse, stop);
+    }
+
+    bool contains(int cell) const {
+        const int r = cell / m_cols - m_r0, c = cell % m_cols - m_c0;
+        return r >= 0 && r < m_h && c >= 0 && c < m_w;
+    }
+    int dist(int cell) const { return m_dist[std::size_t(local(cell))]; }
+
+    // Appends the cells after the source up to cell (forward runs only)
+    void appendPath(int cell, std::vector<int> &out) const {
+        const std::size_t mark = out.size();
+        for (int at = local(cell); m_parent[std::size_t(at)] != -1; at = m_parent[std::size_t(at)])
+            out.push_back(global(at));
+        std::reverse(out.begin() + std::ptrdiff_t(mark), out.end());
+    }
+
+private:
+    int local(int cell) const { return (cell / m_cols - m_r0) * m_w + (cell % m_cols - m_c0); }
+    int global(int l) const { return (m_r0 + l / m_w) * m_cols + m_c0 + l % m_w; }
+
+    // Calls fn(neighbor) for the free 4-neighbors of l inside the cluster
+    template <typename Fn>
+    void forEachLocalNeighbor(int l, Fn &&fn) const {
+        const int r = l / m_w, c = l - r * m_w;
+        if (r + 1 < m_h && !m_wall[std::size_t(l + m_w)]) fn(l + m_w);
+        if (r > 0 && !m_wall[std::size_t(l - m_w)]) fn(l - m_w);
+        if (c + 1 < m_w && !m_wall[std::size_t(l + 1)]) fn(l + 1);
+        if (c > 0 && !m_wall[std::size_t(l - 1)]) fn(l - 1);
+    }
+
+    void runBfs(int from, int stop) {
+        const int step = m_cost[0];
+        m_queue.clear();
+        m_queue.push_back(from);
+        for (std::size_t head = 0; head < m_queue.size(); ++head) {
+            const int cur = m_queue[head];
+            if (cur == stop) break;
+            forEachLocalNeighbor(cur, [&](int nb) {
+                if (m_dist[std::size_t(nb)] != INF) return;
+                m_dist[std::size_t(nb)] = m_dist[std::size_t(cur)] + step;
+                m_parent[std::size_t(nb)] = cur;
+                m_queue.push_back(nb);
+            });
+        }
+    }
+
+    void runDijkstra(int from, bool reverse, int stop) {
+        m_open.clear();
+        m_open.push(0, 0, from);
+        while (!m_open.empty()) {
+            const OpenEntry top = m_open.pop();
+            const int cur = top.cell;
+            if (top.f != m_dist[std::size_t(cur)]) continue;
+            if (cur == stop) break;
+            forEachLocalNeighbor(cur, [&](int nb) {
+                const int nd = top.f + m_cost[std::size_t(reverse ? cur : nb)];
+                if (nd >= m_dist[std::size_t(nb)]) return;
+                m_dist[std::size_t(nb)] = nd;
+                m_parent[std::size_t(nb)] = cur;
+                m_open.push(nd, 0, nb);
+            });
+        }
+    }
+
+    int m_cols = 0, m_r0 = 0, m_c0 = 0, m_w = 0, m_h = 0;
+    bool m_uniform = true;
+    std::vector<std::uint8_t> m_wall;
+    std::vector<std::uint8_t> m_cost;
+    std::vector<int> m_dist;
+    std::vector<int> m_parent;
+    std::vector<int> m_queue;
+    BinaryHeap m_open;
+};
+
+} // namespace
+
+HierarchicalGraph::HierarchicalGraph(int clusterSize)
+    : m_clusterSize(std::max(2, clusterSize))
+{}
+
+void HierarchicalGraph::clear() {
+    m_clusters.clear();
+    m_firstNode.clear();
+    m_nodeCell.clear();
+    m_nodeCluster.clear();
+    m_nodeCount = 0;
+    m_clusterRows = m_clusterCols = 0;
+    m_snapshot.clear();
+}
+
+int HierarchicalGraph::clusterOf(const GridMap &grid, int cell) const {
+    return (grid.rowOf(cell) / m_clusterSize) * m_clusterCols + grid.colOf(cell) / m_clusterSize;
+}
+
+const HierarchicalGraph::UpdateStats &HierarchicalGraph::update(const GridMap &grid, SearchObserver *observer) {
+    const auto t0 = Clock::now();
+    m_lastUpdate = UpdateStats();
+    if (grid.empty()) { clear(); return m_lastUpdate; }
+    if (valid() && m_snapshot.sameVersion(grid)) {
+        m_lastUpdate.incremental = true;
+        return m_lastUpdate;
+    }
+
+    std::vector<int> changed;
+    if (valid() && m_snapshot.sameShape(grid)
+        && m_snapshot.diff(grid, std::size_t(grid.size()) / kRebuildDivisor, changed)) {
+        m_lastUpdate.incremental = true;
+        m_lastUpdate.cellsChanged = std::int64_t(changed.size());
+
+        std::vector<std::uint8_t> dirty(m_clusters.size(), 0);
+        const int cs = m_clusterSize;
+        for (int cell : changed) {
+            const int r = grid.rowOf(cell), c = grid.colOf(cell);
+            const int cr = r / cs, cc = c / cs;
+            dirty[std::size_t(cr * m_clusterCols + cc)] = 1;
+            // Entrances depend on the walls on both sides of a border; costs only matter inside
+            if (grid.cell(cell) == m_snapshot.cell(cell)) continue;
+            if (r % cs == 0 && cr > 0) dirty[std::size_t((cr - 1) * m_clusterCols + cc)] = 1;
+            if (r % cs == cs - 1 && cr + 1 < m_clusterRows) dirty[std::size_t((cr + 1) * m_clusterCols + cc)] = 1;
+            if (c % cs == 0 && cc > 0) dirty[std::size_t(cr * m_clusterCols + cc - 1)] = 1;
+            if (c % cs == cs - 1 && cc + 1 < m_clusterCols) dirty[std::size_t(cr * m_clusterCols + cc + 1)] = 1;
+        }
+        for (std::size_t i = 0; i < dirty.size(); ++i) {
+            if (!dirty[i]) continue;
+            if (observer && observer->shouldAbort()) { m_lastUpdate.aborted = true; break; }
+            buildCluster(grid, int(i));
+            ++m_lastUpdate.clustersRebuilt;
+        }
+        if (m_lastUpdate.clustersRebuilt > 0) renumber();
+        m_snapshot.apply(grid, changed);
+    } else {
+        m_lastUpdate.aborted = !build(grid, observer);
+        m_lastUpdate.clustersRebuilt = clusterCount();
+        m_lastUpdate.cellsChanged = std::int64_t(grid.size());
+    }
+    if (m_lastUpdate.aborted) clear();
+    m_lastUpdate.elapsedMs = elapsedSince(t0);
+    return m_lastUpdate;
+}
+
+bool HierarchicalGraph::build(const GridMap &grid, SearchObserver *observer) {
+    m_clusterRows = (grid.rows() + m_clusterSize - 1) / m_clusterSize;
+    m_clusterCols = (grid.cols() + m_clusterSize - 1) / m_clusterSize;
+    m_clusters.assign(std::size_t(m_clusterRows) * std::size_t(m_clusterCols), Cluster());
+    for (int i = 0; i < clusterCount(); ++i) {
+        if (observer && observer->shouldAbort()) return false;
+        Cluster &cluster = m_clusters[std::size_t(i)];
+        cluster.r0 = (i / m_clusterCols) * m_clusterSize;
+        cluster.c0 = (i % m_clusterCols) * m_clusterSize;
+        cluster.r1 = std::min(grid.rows(), cluster.r0 + m_clusterSize);
+        cluster.c1 = std::min(grid.cols(), cluster.c0 + m_clusterSize);
+        buildCluster(grid, i);
+    }
+    renumber();
+    m_snapshot.assign(grid);
+    return true;
+}
+
+void HierarchicalGraph::buildCluster(const GridMap &grid, int index) {
+    Cluster &cluster = m_clusters[std::size_t(index)];
+    cluster.nodes.clear();
+    cluster.exits.clear();
+    addEntrances(grid, cluster, -1, 0);
+    addEntrances(grid, cluster, 1, 0);
+    addEntrances(grid, cluster, 0, -1);
+    addEntrances(grid, cluster, 0, 1);
+
+    const std::size_t k = cluster.nodes.size();
+    cluster.dist.assign(k * k, INF);
+    thread_local LocalSearch search;
+    search.load(grid, cluster.r0, cluster.c0, cluster.r1, cluster.c1);
+    for (std::size_t i = 0; i < k; ++i) {
+        search.run(cluster.nodes[i], false);
+        for (std::size_t j = 0; j < k; ++j)
+            cluster.dist[i * k + j] = search.dist(cluster.nodes[j]);
+    }
+}
+
+/**
+ * Entrances on the border towards (dr, dc). Both clusters run the same scan
+ * over the same cell pairs, so they agree on the transitions without
+ * looking at each other's state.
+ */
+void HierarchicalGraph::addEntrances(const GridMap &grid, Cluster &cluster, int dr, int dc) {
+    const bool vertical = dc != 0; // the border runs down a column
+    const int len = vertical ? cluster.r1 - cluster.r0 : cluster.c1 - cluster.c0;
+    const int edgeRow = dr > 0 ? cluster.r1 - 1 : cluster.r0;
+    const int edgeCol = dc > 0 ? cluster.c1 - 1 : cluster.c0;
+    if (!grid.inBounds(edgeRow + dr, edgeCol + dc)) return;
+
+    auto insideCell = [&](int i) {
+        return vertical ? grid.index(cluster.r0 + i, edgeCol) : grid.index(edgeRow, cluster.c0 + i);
+    };
+    const int across = dr * grid.cols() + dc;
+    auto addTransition = [&](int inside) {
+        int node = localNode(cluster, inside);
+        if (node < 0) {
+            node = int(cluster.nodes.size());
+            cluster.nodes.push_back(inside);
+        }
+        cluster.exits.push_back(Transition{node, inside + across});
+    };
+
+    int runStart = -1;
+    for (int i = 0; i <= len; ++i) {
+        const bool open = i < len && !grid.isWall(insideCell(i)) && !grid.isWall(insideCell(i) + across);
+        if (open && runStart < 0) runStart = i;
+        if (open || runStart < 0) continue;
+        const int runLength = i - runStart;
+        if (runLength < kLongEntrance) {
+            addTransition(insideCell(runStart + (runLength - 1) / 2));
+        } else {
+            addTransition(insideCell(runStart));
+            addTransition(insideCell(i - 1));
+        }
+        runStart = -1;
+    }
+}
+
+void HierarchicalGraph::renumber() {
+    m_firstNode.resize(m_clusters.size());
+    m_nodeCount = 0;
+    for (std::size_t i = 0; i < m_clusters.size(); ++i) {
+        m_firstNode[i] = m_nodeCount;
+        m_nodeCount += int(m_clusters[i].nodes.size());
+    }
+    m_nodeCell.resize(std::size_t(m_nodeCount));
+    m_nodeCluster.resize(std::size_t(m_nodeCount));
+    for (std::size_t i = 0; i < m_clusters.size(); ++i) {
+        for (std::size_t j = 0; j < m_clusters[i].nodes.size(); ++j) {
+            m_nodeCell[std::size_t(m_firstNode[i]) + j] = m_clusters[i].nodes[j];
+            m_nodeCluster[std::size_t(m_firstNode[i]) + j] = int(i);
+        }
+    }
+}
+
+int HierarchicalGraph::localNode(const Cluster &cluster, int cell) const {
+    for (std::size_t i = 0; i < cluster.nodes.size(); ++i)
+        if (cluster.nodes[i] == cell) return int(i);
+    return -1;
+}
+
+SearchResult HierarchicalGraph::query(const GridMap &grid, int start, int target, SearchObserver *observer) {
+    SearchResult result;
+    m_lastRefineMs = 0.0;
+    if (!validQuery(grid, start, target)) return result;
+    const auto t0 = Clock::now();
+    if (update(grid, observer).aborted) {
+        result.aborted = true;
+        return result;
+    }
+
+    if (start == target) {
+        result.found = true;
+        result.path.push_back(start);
+        result.stats.elapsedMs = elapsedSince(t0);
+        return result;
+    }
+    if (grid.isWall(target)) { result.stats.elapsedMs = elapsedSince(t0); return result; }
+
+    // Start and target join the abstract graph as two extra nodes
+    const int startCluster = clusterOf(grid, start);
+    const int targetCluster = clusterOf(grid, target);
+    const Cluster &tc = m_clusters[std::size_t(targetCluster)];
+    LocalSearch toTarget;
+    toTarget.load(grid, tc.r0, tc.c0, tc.r1, tc.c1);
+    toTarget.run(target, true);
+
+    // A wall start is never part of an entrance, yet its first step may
+    // cross a border: search each cluster it can step into from there
+    struct Departure {
+        int cluster;
+        int firstStep; // -1: start itself
+        LocalSearch search;
+    };
+    std::vector<Departure> departures;
+    departures.push_back(Departure{startCluster, -1, LocalSearch()});
+    if (grid.isWall(start)) {
+        forEachNeighbor(grid, start, [&](int nb) {
+            if (clusterOf(grid, nb) != startCluster) departures.push_back(Departure{clusterOf(grid, nb), nb, LocalSearch()});
+        });
+    }
+    for (Departure &d : departures) {
+        const Cluster &cluster = m_clusters[std::size_t(d.cluster)];
+        d.search.load(grid, cluster.r0, cluster.c0, cluster.r1, cluster.c1);
+        d.search.run(d.firstStep < 0 ? start : d.firstStep, false);
+    }
+
+    const int S = m_nodeCount, T = m_nodeCount + 1;
+    auto cellOf = [&](int node) { return node == S ? start : node == T ? target : m_nodeCell[std::size_t(node)]; };
+    const int hScale = grid.minCost();
+    auto h = [&](int node) { return manhattan(grid, cellOf(node), target) * hScale; };
+
+    std::vector<int> g(std::size_t(m_nodeCount) + 2, INF);
+    std::vector<int> parent(g.size(), -1);
+    std::vector<std::uint8_t> closed(g.size(), 0);
+    BinaryHeap open;
+    auto relax = [&](int from, int to, int cost) {
+        if (cost >= INF || closed[std::size_t(to)]) return;
+        const int nd = g[std::size_t(from)] + cost;
+        if (nd >= g[std::size_t(to)]) return;
+        g[std::size_t(to)] = nd;
+        parent[std::size_t(to)] = from;
+        const int hv = h(to);
+        open.push(nd + hv, hv, to);
+        ++result.stats.nodesGenerated;
+    };
+
+    g[std::size_t(S)] = 0;
+    open.push(h(S), h(S), S);
+    while (!open.empty()) {
+        if (observer && observer->shouldAbort()) { result.aborted = true; break; }
+        const int u = open.pop().cell;
+        if (closed[std::size_t(u)]) continue;
+        closed[std::size_t(u)] = 1;
+        ++result.stats.nodesExpanded;
+        if (observer) observer->onVisit(cellOf(u));
+        if (u == T) break;
+
+        if (u == S) {
+            for (const Departure &d : departures) {
+                const int step = d.firstStep < 0 ? 0 : grid.cost(d.firstStep);
+                const Cluster &cluster = m_clusters[std::size_t(d.cluster)];
+                for (std::size_t j = 0; j < cluster.nodes.size(); ++j) {
+                    const int dist = d.search.dist(cluster.nodes[j]);
+                    if (dist < INF) relax(S, m_firstNode[std::size_t(d.cluster)] + int(j), step + dist);
+                }
+                if (d.cluster == targetCluster && d.search.dist(target) < INF)
+                    relax(S, T, step + d.search.dist(target));
+            }
+            continue;
+        }
+        const int ci = m_nodeCluster[std::size_t(u)];
+        const Cluster &cluster = m_clusters[std::size_t(ci)];
+        const int i = u - m_firstNode[std::size_t(ci)];
+        const std::size_t k = cluster.nodes.size();
+        for (std::size_t j = 0; j < k; ++j)
+            if (int(j) != i) relax(u, m_firstNode[std::size_t(ci)] + int(j), cluster.dist[std::size_t(i) * k + j]);
+        for (const Transition &exit : cluster.exits) {
+            if (exit.node != i) continue;
+            const int other = clusterOf(grid, exit.cell);
+            const int j = localNode(m_clusters[std::size_t(other)], exit.cell);
+            if (j >= 0) relax(u, m_firstNode[std::size_t(other)] + j, grid.cost(exit.cell));
+        }
+        if (ci == targetCluster) relax(u, T, toTarget.dist(cluster.nodes[std::size_t(i)]));
+    }
+
+    if (!result.aborted && g[std::size_t(T)] < INF) {
+        // Refine: steps across a border are single moves, everything else a search inside one cluster
+        const auto tRefine = Clock::now();
+        std::vector<int> chain;
+        for (int at = T; at != -1; at = parent[std::size_t(at)])
+            chain.push_back(cellOf(at));
+        std::reverse(chain.begin(), chain.end());
+
+        result.path.push_back(start);
+        LocalSearch refine;
+        for (std::size_t s = 1; s < chain.size(); ++s) {
+            int from = chain[s - 1];
+            const int to = chain[s];
+            if (from == to) continue;
+            const int ci = clusterOf(grid, to);
+            if (s == 1 && ci != startCluster) {
+                // First step out of a wall start into the neighbor cluster
+                for (const Departure &d : departures)
+                    if (d.cluster == ci) from = d.firstStep;
+                result.path.push_back(from);
+            } else if (ci != clusterOf(grid, from)) {
+                result.path.push_back(to);
+                continue;
+            }
+            if (from == to) continue;
+            const Cluster &cluster = m_clusters[std::size_t(ci)];
+            refine.load(grid, cluster.r0, cluster.c0, cluster.r1, cluster.c1);
+            refine.run(from, false, to);
+            refine.appendPath(to, result.path);
+        }
+        m_lastRefineMs = elapsedSince(tRefine);
+        result.found = true;
+        result.pathCost = pathCostOf(grid, result.path);
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+SearchResult hpaSearch(const GridMap &grid, int start, int target, SearchObserver *observer,
+                       const SearchOptions &options) {
+    // The abstract graph is small, so a binary heap is all it needs; its counters only split the time
+    thread_local HierarchicalGraph graph;
+    return withCounters(options, [&](auto counters) {
+        SearchResult result = graph.query(grid, start, target, observer);
+        counters.pathTook(graph.lastRefineMs());
+        counters.report(result.stats);
+        return result;
+    });
+}
+
+} // namespace pathfinding
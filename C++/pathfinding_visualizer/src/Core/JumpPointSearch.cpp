@@ -0,0 +1,266 @@
+#include "Core/JumpPointSearch.hpp"
+#include "Core/BitGrid.hpp"
+#include "Core/BitOps.hpp"
+#include "SearchInternal.hpp"
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+/**
+ * Reads walls straight from the GridMap and steps one cell at a time.
+ */
+class CellScanner {
+public:
+    CellScanner(const GridMap &grid, int target)
+        : m_grid(grid), m_targetRow(grid.rowOf(target)), m_targetCol(grid.colOf(target)) {}
+
+    bool free(int r, int c) const { return m_grid.inBounds(r, c) && !m_grid.isWall(r, c); }
+    // Scratch this query had to allocate for the scanner
+    std::size_t allocatedBytes() const { return 0; }
+
+    // Column of the first jump point east (dc = 1) or west (dc = -1) of (r, c), or -1
+    int jumpHorizontal(int r, int c, int dc) const {
+        for (int x = c + dc;; x += dc) {
+            if (!free(r, x)) return -1;
+            if (r == m_targetRow && x == m_targetCol) return x;
+            if ((free(r - 1, x) && !free(r - 1, x - dc)) || (free(r + 1, x) && !free(r + 1, x - dc)))
+                return x;
+        }
+    }
+
+private:
+    const GridMap &m_grid;
+    int m_targetRow;
+    int m_targetCol;
+};
+
+// Built once per map contents and thread, like the any-angle searches' LineOfSight
+const BitGrid &bitGridFor(const GridMap &grid, bool &rebuilt) {
+    thread_local BitGrid cached;
+    thread_local std::uint64_t cachedVersion = 0; // GridMap versions are never 0
+    rebuilt = cachedVersion != grid.version();
+    if (rebuilt) {
+        cached = BitGrid(grid);
+        cachedVersion = grid.version();
+    }
+    return cached;
+}
+
+/**
+ * Same jumps on a BitGrid: a forced neighbor above is a free cell whose
+ * predecessor (one column back) is blocked, i.e. ~above & aboveBehind, so a
+ * whole 64-cell window is tested with a few word operations and the first
+ * hit before the first wall is found with a trailing-zero count.
+ */
+class BlockScanner {
+public:
+    BlockScanner(const GridMap &grid, int target)
+        : m_bits(bitGridFor(grid, m_rebuilt)), m_targetRow(grid.rowOf(target)), m_targetCol(grid.colOf(target)) {}
+
+    bool free(int r, int c) const { return !m_bits.blocked(r, c); }
+    std::size_t allocatedBytes() const { return m_rebuilt ? m_bits.memoryBytes() : 0; }
+
+    int jumpHorizontal(int r, int c, int dc) const {
+        return dc > 0 ? jumpEast(r, c + 1) : jumpWest(r, c - 1);
+    }
+
+private:
+    int jumpEast(int r, int x) const {
+        for (;; x += 64) {
+            const std::uint64_t walls = m_bits.windowEast(r, x);
+            std::uint64_t hits = (~m_bits.windowEast(r - 1, x) & m_bits.windowEast(r - 1, x - 1))
+                               | (~m_bits.windowEast(r + 1, x) & m_bits.windowEast(r + 1, x - 1));
+            if (r == m_targetRow && m_targetCol >= x && m_targetCol - x < 64)
+                hits |= std::uint64_t(1) << (m_targetCol - x);
+            if (walls) hits &= (walls & (0 - walls)) - 1; // cells before the first wall
+            if (hits) return x + countTrailingZeros64(hits);
+            if (walls) return -1;
+        }
+    }
+
+    int jumpWest(int r, int x) const {
+        for (;; x -= 64) {
+            const std::uint64_t walls = m_bits.windowWest(r, x);
+            std::uint64_t hits = (~m_bits.windowWest(r - 1, x) & m_bits.windowWest(r - 1, x + 1))
+                               | (~m_bits.windowWest(r + 1, x) & m_bits.windowWest(r + 1, x + 1));
+            if (r == m_targetRow && m_targetCol <= x && x - m_targetCol < 64)
+                hits |= std::uint64_t(1) << (x - m_targetCol);
+            if (walls) hits &= (walls & (0 - walls)) - 1;
+            if (hits) return x - countTrailingZeros64(hits);
+            if (walls) return -1;
+        }
+    }
+
+    bool m_rebuilt = false; // declared before m_bits, which sets it
+    const BitGrid &m_bits;
+    int m_targetRow;
+    int m_targetCol;
+};
+
+/**
+ * Row of the first jump point north (dr = -1) or south (dr = 1) of (r, c), or -1.
+ * A vertical jump also stops where a horizontal jump would find something,
+ * since with 4-connectivity the turn can only happen on the vertical line.
+ */
+template <typename Scanner>
+int jumpVertical(const Scanner &scan, int r, int c, int dr, int targetRow, int targetCol) {
+    for (int y = r + dr;; y += dr) {
+        if (!scan.free(y, c)) return -1;
+        if (y == targetRow && c == targetCol) return y;
+        if ((scan.free(y, c - 1) && !scan.free(y - dr, c - 1)) || (scan.free(y, c + 1) && !scan.free(y - dr, c + 1)))
+            return y;
+        if (scan.jumpHorizontal(y, c, 1) >= 0 || scan.jumpHorizontal(y, c, -1) >= 0)
+            return y;
+    }
+}
+
+inline int sign(int v) { return (v > 0) - (v < 0); }
+
+/**
+ * A* over jump points. g and h are counted in steps (every cell costs the
+ * same), and each edge is a straight run, so Manhattan stays consistent.
+ */
+template <typename Scanner, typename OpenList, typename Counters>
+SearchResult jpsWith(OpenList &open, Counters &counters, SearchContext &context, const Scanner &scan,
+                     const GridMap &grid, int start, int target, SearchObserver *observer) {
+    SearchResult result;
+    const auto t0 = Clock::now();
+
+    const int cols = grid.cols();
+    const int targetRow = grid.rowOf(target), targetCol = grid.colOf(target);
+    context.reset(grid.size());
+    context.setDist(start, 0);
+    context.setParent(start, -1);
+    const int h0 = manhattan(grid, start, target);
+    open.push(h0, h0, start);
+    counters.pushed(open.size());
+
+    while (!open.empty()) {
+        if (observer && observer->shouldAbort()) { result.aborted = true; break; }
+        const int cur = open.pop().cell;
+        counters.popped();
+        if (context.closed(cur)) { counters.stale(); continue; }
+        context.setClosed(cur);
+
+        ++result.stats.nodesExpanded;
+        if (observer) observer->onVisit(cur);
+
+        if (cur == target) break;
+
+        const int r = cur / cols, c = cur - r * cols;
+        const int g = context.dist(cur);
+        const int from = context.parent(cur);
+
+        // Natural neighbors: straight on plus both sides when moving, all four from the start
+        int dirs[4][2];
+        int count = 0;
+        if (from == -1) {
+            dirs[0][0] = 1; dirs[0][1] = 0; dirs[1][0] = -1; dirs[1][1] = 0;
+            dirs[2][0] = 0; dirs[2][1] = 1; dirs[3][0] = 0; dirs[3][1] = -1;
+            count = 4;
+        } else {
+            const int dr = sign(r - grid.rowOf(from));
+            const int dc = sign(c - grid.colOf(from));
+            if (dc != 0) {
+                dirs[0][0] = -1; dirs[0][1] = 0; dirs[1][0] = 1; dirs[1][1] = 0;
+                dirs[2][0] = 0; dirs[2][1] = dc;
+            } else {
+                dirs[0][0] = 0; dirs[0][1] = -1; dirs[1][0] = 0; dirs[1][1] = 1;
+                dirs[2][0] = dr; dirs[2][1] = 0;
+            }
+            count = 3;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int jr = r, jc = c;
+            if (dirs[i][0] == 0) {
+                jc = scan.jumpHorizontal(r, c, dirs[i][1]);
+                if (jc < 0) continue;
+            } else {
+                jr = jumpVertical(scan, r, c, dirs[i][0], targetRow, targetCol);
+                if (jr < 0) continue;
+            }
+            const int jp = jr * cols + jc;
+            if (context.closed(jp)) continue;
+            const int tentative = g + std::abs(jr - r) + std::abs(jc - c);
+            if (tentative < context.dist(jp)) {
+                context.setDist(jp, tentative);
+                context.setParent(jp, cur);
+                const int h = manhattan(grid, jp, target);
+                open.push(tentative + h, h, jp);
+                counters.pushed(open.size());
+                ++result.stats.nodesGenerated;
+            }
+        }
+    }
+
+    if (!result.aborted && context.dist(target) != INF) {
+        // Fill in the straight runs between consecutive jump points
+        const auto tPath = counters.pathStart();
+        std::vector<int> jumps;
+        reconstructPath(context, target, jumps);
+        result.path.reserve(static_cast<std::size_t>(context.dist(target)) + 1);
+        result.path.push_back(jumps.front());
+        for (std::size_t i = 1; i < jumps.size(); ++i) {
+            const int from = jumps[i - 1], to = jumps[i];
+            const int step = grid.rowOf(from) == grid.rowOf(to) ? sign(to - from) : sign(to - from) * cols;
+            for (int at = from + step; at != to; at += step)
+                result.path.push_back(at);
+            result.path.push_back(to);
+        }
+        counters.pathBuilt(tPath);
+        counters.allocated((jumps.capacity() + result.path.capacity()) * sizeof(int));
+        result.found = true;
+        result.pathCost = pathCostOf(grid, result.path);
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+template <typename Scanner>
+SearchResult runJps(const GridMap &grid, int start, int target, SearchContext &context, SearchObserver *observer,
+                    const SearchOptions &options) {
+    if (!validQuery(grid, start, target)) return SearchResult();
+    if (grid.minCost() != grid.maxCost())
+        return aStar(grid, start, target, context, observer, options);
+    return withCounters(options, [&](auto counters) {
+        const Scanner scan(grid, target);
+        counters.allocated(scan.allocatedBytes());
+        counters.trackContext(context);
+        // One jump raises f by at most twice its length
+        const int span = 2 * std::max(grid.rows(), grid.cols()) + 1;
+        SearchResult result = withOpenList(context, options, span, [&](auto &open) {
+            return jpsWith(open, counters, context, scan, grid, start, target, observer);
+        });
+        counters.settleContext(context);
+        counters.report(result.stats);
+        return result;
+    });
+}
+
+} // namespace
+
+SearchResult jumpPointSearch(const GridMap &grid, int start, int target, SearchObserver *observer,
+                             const SearchOptions &options) {
+    return runJps<CellScanner>(grid, start, target, threadContext(), observer, options);
+}
+
+SearchResult jumpPointSearch(const GridMap &grid, int start, int target, SearchContext &context,
+                             SearchObserver *observer, const SearchOptions &options) {
+    return runJps<CellScanner>(grid, start, target, context, observer, options);
+}
+
+SearchResult blockJumpPointSearch(const GridMap &grid, int start, int target, SearchObserver *observer,
+                                  const SearchOptions &options) {
+    return runJps<BlockScanner>(grid, start, target, threadContext(), observer, options);
+}
+
+SearchResult blockJumpPointSearch(const GridMap &grid, int start, int target, SearchContext &context,
+                                  SearchObserver *observer, const SearchOptions &options) {
+    return runJps<BlockScanner>(grid, start, target, context, observer, options);
+}
+
+} // namespace pathfinding
@@ -0,0 +1,74 @@
+#include "Core/LineOfSight.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace pathfinding {
+
+namespace {
+
+std::int64_t floorDiv(std::int64_t a, std::int64_t b) {
+    const std::int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+std::int64_t ceilDiv(std::int64_t a, std::int64_t b) {
+    return -floorDiv(-a, b);
+}
+
+/**
+ * Walks the segment between the centers of (r0, c0) and (r1, c1) row by row
+ * on bits. Coordinates are doubled so centers sit on odd integers and every
+ * bound is an exact fraction: row r covers y in [2r, 2r + 2], and on it the
+ * segment covers x in [lo, hi], which touches the columns
+ * ceil(lo / 2) - 1 .. floor(hi / 2).
+ */
+bool sweepRows(const BitGrid &bits, int r0, int c0, int r1, int c1) {
+    if (r0 > r1) {
+        std::swap(r0, r1);
+        std::swap(c0, c1);
+    }
+    if (r0 == r1) return !bits.anyBlocked(r0, std::min(c0, c1), std::max(c0, c1));
+
+    const std::int64_t y0 = 2 * std::int64_t(r0) + 1, y1 = 2 * std::int64_t(r1) + 1;
+    const std::int64_t x0 = 2 * std::int64_t(c0) + 1, x1 = 2 * std::int64_t(c1) + 1;
+    const std::int64_t dy = y1 - y0, dx = x1 - x0;
+    for (int r = r0; r <= r1; ++r) {
+        const std::int64_t ya = std::max<std::int64_t>(2 * std::int64_t(r), y0);
+        const std::int64_t yb = std::min<std::int64_t>(2 * std::int64_t(r) + 2, y1);
+        // x * dy at both ends of the row's piece
+        const std::int64_t xa = x0 * dy + (ya - y0) * dx;
+        const std::int64_t xb = x0 * dy + (yb - y0) * dx;
+        const int first = int(ceilDiv(std::min(xa, xb), 2 * dy)) - 1;
+        const int last = int(floorDiv(std::max(xa, xb), 2 * dy));
+        if (bits.anyBlocked(r, first, last)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+LineOfSight::LineOfSight(const GridMap &grid)
+    : m_rows(grid.rows()),
+      m_cols(grid.cols()),
+      m_version(grid.version()),
+      m_byRow(grid)
+{
+    GridMap transposed(m_cols, m_rows);
+    for (int r = 0; r < m_rows; ++r)
+        for (int c = 0; c < m_cols; ++c)
+            if (grid.isWall(r, c)) transposed.setWall(c, r, true);
+    m_byCol = BitGrid(transposed);
+}
+
+bool LineOfSight::visible(int from, int to) const {
+    const int r0 = from / m_cols, c0 = from % m_cols;
+    const int r1 = to / m_cols, c1 = to % m_cols;
+    // Sweep along the shorter axis so each span is as long as possible
+    if (std::abs(r1 - r0) <= std::abs(c1 - c0))
+        return sweepRows(m_byRow, r0, c0, r1, c1);
+    return sweepRows(m_byCol, c0, r0, c1, r1);
+}
+
+} // namespace pathfinding
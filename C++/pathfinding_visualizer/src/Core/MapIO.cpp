@@ -0,0 +1,261 @@
+#include "Core/MapIO.hpp"
+#include "Core/MappedFile.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace pathfinding {
+
+namespace {
+
+const char kBinaryMagic[4] = {'P', 'F', 'G', 'M'};
+const std::uint32_t kBinaryVersion = 1;
+const std::uint32_t kBinaryVersionWithCosts = 2;
+const std::size_t kBinaryHeaderSize = 16;
+
+bool fail(std::string *error, const std::string &msg) {
+    if (error) *error = msg;
+    return false;
+}
+
+bool hasExtension(const std::string &path, const char *ext) {
+    const std::size_t n = std::strlen(ext);
+    if (path.size() < n) return false;
+    for (std::size_t i = 0; i < n; ++i) {
+        char a = path[path.size() - n + i];
+        if (a >= 'A' && a <= 'Z') a = char(a - 'A' + 'a');
+        if (a != ext[i]) return false;
+    }
+    return true;
+}
+
+// Checked before a GridMap is built, so a bogus header cannot make the loader allocate for it
+bool tooManyCells(std::int64_t rows, std::int64_t cols) {
+    return rows * cols > GridMap::MaxCells;
+}
+
+inline bool isPassableTerrain(char t) {
+    return t == '.' || t == 'G' || t == 'S';
+}
+
+std::uint32_t readU32(const unsigned char *p) {
+    return std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8) | (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+}
+
+void writeU32(std::FILE *f, std::uint32_t v) {
+    const unsigned char b[4] = {
+        static_cast<unsigned char>(v), static_cast<unsigned char>(v >> 8),
+        static_cast<unsigned char>(v >> 16), static_cast<unsigned char>(v >> 24)
+    };
+    std::fwrite(b, 1, 4, f);
+}
+
+} // namespace
+
+bool loadMovingAiMap(const std::string &path, GridMap &out, std::string *error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return fail(error, "cannot open " + path);
+
+    int width = -1, height = -1;
+    std::string key;
+    while (in >> key) {
+        if (key == "type") {
+            std::string type;
+            in >> type;
+        } else if (key == "height") {
+            in >> height;
+        } else if (key == "width") {
+            in >> width;
+        } else if (key == "map") {
+            break;
+        } else {
+            return fail(error, "unexpected header field '" + key + "' in " + path);
+        }
+    }
+    if (width <= 0 || height <= 0) return fail(error, "missing width/height in " + path);
+    if (tooManyCells(height, width)) return fail(error, "map too large in " + path);
+
+    std::string line;
+    std::getline(in, line); // rest of the "map" line
+    // Every row takes at least width characters and a line break
+    const std::streampos rowsBegin = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::int64_t remaining = std::int64_t(in.tellg() - rowsBegin);
+    in.seekg(rowsBegin);
+    if (remaining < std::int64_t(height) * width + height - 1) return fail(error, "truncated map data in " + path);
+
+    GridMap grid(height, width);
+    for (int r = 0; r < height; ++r) {
+        if (!std::getline(in, line)) return fail(error, "truncated map data in " + path);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (static_cast<int>(line.size()) < width) return fail(error, "short map row in " + path);
+        const int base = r * width;
+        for (int c0 = 0; c0 < width; c0 += 64) {
+            const int n = width - c0 < 64 ? width - c0 : 64;
+            std::uint64_t bits = 0;
+            for (int i = 0; i < n; ++i)
+                if (!isPassableTerrain(line[c0 + i])) bits |= std::uint64_t(1) << i;
+            if (bits) grid.setWalls(base + c0, bits, n);
+        }
+    }
+    out = std::move(grid);
+    return true;
+}
+
+bool saveMovingAiMap(const std::string &path, const GridMap &grid, std::string *error) {
+    std::ofstream outFile(path, std::ios::binary);
+    if (!outFile) return fail(error, "cannot write " + path);
+
+    outFile << "type octile\nheight " << grid.rows() << "\nwidth " << grid.cols() << "\nmap\n";
+    std::string line(static_cast<std::size_t>(grid.cols()), '.');
+    for (int r = 0; r < grid.rows(); ++r) {
+        for (int c = 0; c < grid.cols(); ++c)
+            line[c] = grid.isWall(r, c) ? '@' : '.';
+        outFile << line << '\n';
+    }
+    return outFile.good() || fail(error, "write error on " + path);
+}
+
+bool loadMovingAiScenarios(const std::string &path, std::vector<Scenario> &out, std::string *error) {
+    std::ifstream in(path);
+    if (!in) return fail(error, "cannot open " + path);
+
+    std::vector<Scenario> scenarios;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line.compare(0, 7, "version") == 0) continue;
+
+        // Fields are tab separated in the published sets; fall back to whitespace
+        std::vector<std::string> f;
+        std::istringstream fields(line);
+        std::string field;
+        if (line.find('\t') != std::string::npos) {
+            while (std::getline(fields, field, '\t')) f.push_back(field);
+        } else {
+            while (fields >> field) f.push_back(field);
+        }
+        if (f.size() < 9)
+            return fail(error, path + ":" + std::to_string(lineNo) + ": malformed scenario line");
+
+        Scenario s;
+        try {
+            s.bucket = std::stoi(f[0]);
+            s.mapFile = f[1];
+            s.mapWidth = std::stoi(f[2]);
+            s.mapHeight = std::stoi(f[3]);
+            s.startX = std::stoi(f[4]);
+            s.startY = std::stoi(f[5]);
+            s.goalX = std::stoi(f[6]);
+            s.goalY = std::stoi(f[7]);
+            s.optimalLength = std::stod(f[8]);
+        } catch (const std::exception &) {
+            return fail(error, path + ":" + std::to_string(lineNo) + ": malformed number");
+        }
+        scenarios.push_back(std::move(s));
+    }
+    out = std::move(scenarios);
+    return true;
+}
+
+bool saveMovingAiScenarios(const std::string &path, const std::vector<Scenario> &scenarios,
+                           std::string *error) {
+    std::ofstream outFile(path);
+    if (!outFile) return fail(error, "cannot write " + path);
+
+    outFile << "version 1\n";
+    char optimal[32];
+    for (const Scenario &s : scenarios) {
+        std::snprintf(optimal, sizeof(optimal), "%.8f", s.optimalLength);
+        outFile << s.bucket << '\t' << s.mapFile << '\t' << s.mapWidth << '\t' << s.mapHeight << '\t'
+                << s.startX << '\t' << s.startY << '\t' << s.goalX << '\t' << s.goalY << '\t'
+                << optimal << '\n';
+    }
+    return outFile.good() || fail(error, "write error on " + path);
+}
+
+bool loadBinaryMap(const std::string &path, GridMap &out, std::string *error) {
+    MappedFile file;
+    if (!file.open(path, error)) return false;
+    if (file.size() < kBinaryHeaderSize || std::memcmp(file.data(), kBinaryMagic, 4) != 0)
+        return fail(error, path + " is not a PFGM map");
+
+    const unsigned char *p = file.data();
+    const std::uint32_t version = readU32(p + 4);
+    if (version != kBinaryVersion && version != kBinaryVersionWithCosts)
+        return fail(error, "unsupported PFGM version in " + path);
+    const int rows = static_cast<int>(readU32(p + 8));
+    const int cols = static_cast<int>(readU32(p + 12));
+    if (rows <= 0 || cols <= 0) return fail(error, "invalid dimensions in " + path);
+    if (tooManyCells(rows, cols)) return fail(error, "map too large in " + path);
+
+    const std::size_t wordsPerRow = (static_cast<std::size_t>(cols) + 63) / 64;
+    const std::size_t wallBytes = wordsPerRow * 8 * static_cast<std::size_t>(rows);
+    const std::size_t costBytes = version == kBinaryVersionWithCosts
+        ? static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols) : 0;
+    if (file.size() < kBinaryHeaderSize + wallBytes + costBytes) return fail(error, "truncated PFGM map " + path);
+
+    GridMap grid(rows, cols);
+    const unsigned char *words = p + kBinaryHeaderSize;
+    for (int r = 0; r < rows; ++r) {
+        const unsigned char *rowWords = words + static_cast<std::size_t>(r) * wordsPerRow * 8;
+        for (std::size_t w = 0; w < wordsPerRow; ++w) {
+            std::uint64_t bits;
+            std::memcpy(&bits, rowWords + w * 8, 8); // little-endian host assumed
+            const int c0 = static_cast<int>(w * 64);
+            if (bits == 0) continue; // GridMap starts all Free
+            grid.setWalls(r * cols + c0, bits, cols - c0 < 64 ? cols - c0 : 64);
+        }
+    }
+    if (costBytes) grid.setCosts(words + wallBytes);
+    out = std::move(grid);
+    return true;
+}
+
+bool saveBinaryMap(const std::string &path, const GridMap &grid, std::string *error) {
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f) return fail(error, "cannot write " + path);
+
+    std::fwrite(kBinaryMagic, 1, 4, f);
+    writeU32(f, grid.hasCosts() ? kBinaryVersionWithCosts : kBinaryVersion);
+    writeU32(f, static_cast<std::uint32_t>(grid.rows()));
+    writeU32(f, static_cast<std::uint32_t>(grid.cols()));
+
+    const int cols = grid.cols();
+    const std::size_t wordsPerRow = (static_cast<std::size_t>(cols) + 63) / 64;
+    std::vector<std::uint64_t> rowWords(wordsPerRow);
+    for (int r = 0; r < grid.rows(); ++r) {
+        for (std::size_t w = 0; w < wordsPerRow; ++w) {
+            const int c0 = static_cast<int>(w * 64);
+            const int n = cols - c0;
+            const std::uint64_t mask = n >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+            rowWords[w] = grid.wallWindow(r * cols + c0) & mask;
+        }
+        std::fwrite(rowWords.data(), 8, wordsPerRow, f);
+    }
+    if (grid.hasCosts()) std::fwrite(grid.costData(), 1, static_cast<std::size_t>(grid.size()), f);
+    const bool ok = std::ferror(f) == 0;
+    return (std::fclose(f) == 0 && ok) || fail(error, "write error on " + path);
+}
+
+bool loadMap(const std::string &path, GridMap &out, std::string *error) {
+    if (hasExtension(path, ".pfgm")) return loadBinaryMap(path, out, error);
+    if (hasExtension(path, ".map")) return loadMovingAiMap(path, out, error);
+    return fail(error, "unknown map format: " + path);
+}
+
+bool saveMap(const std::string &path, const GridMap &grid, std::string *error) {
+    if (hasExtension(path, ".pfgm")) return saveBinaryMap(path, grid, error);
+    if (hasExtension(path, ".map")) return saveMovingAiMap(path, grid, error);
+    return fail(error, "unknown map format: " + path);
+}
+
+} // namespace pathfinding
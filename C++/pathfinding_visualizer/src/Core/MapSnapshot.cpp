@@ -0,0 +1,85 @@
+#include "Core/MapSnapshot.hpp"
+#include "Core/BitOps.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pathfinding {
+
+namespace {
+
+/**
+ * Appends the indices where a and b differ, comparing 256-byte blocks with
+ * memcmp first. Stops early once more than limit cells were found.
+ */
+void diffBytes(const std::uint8_t *a, const std::uint8_t *b, std::size_t n, std::size_t limit,
+               std::vector<int> &out) {
+    constexpr std::size_t kBlock = 256;
+    for (std::size_t base = 0; base < n && out.size() <= limit; base += kBlock) {
+        const std::size_t len = std::min(kBlock, n - base);
+        if (std::memcmp(a + base, b + base, len) == 0) continue;
+        for (std::size_t i = base; i < base + len; ++i)
+            if (a[i] != b[i]) out.push_back(int(i));
+    }
+}
+
+/**
+ * Appends the cells whose wall bit differs, 64 at a time: equal words are
+ * skipped with one compare and the bits of a changed word are walked with
+ * bit scans. Stops early once more than limit cells were found.
+ */
+void diffWalls(const std::uint64_t *a, const std::uint64_t *b, std::size_t words, std::size_t limit,
+               std::vector<int> &out) {
+    for (std::size_t w = 0; w < words && out.size() <= limit; ++w) {
+        for (std::uint64_t d = a[w] ^ b[w]; d; d &= d - 1)
+            out.push_back(int(w * 64 + countTrailingZeros64(d)));
+    }
+}
+
+} // namespace
+
+void MapSnapshot::assign(const GridMap &grid) {
+    m_rows = grid.rows();
+    m_cols = grid.cols();
+    m_walls.assign(grid.wallWords(), grid.wallWords() + grid.wallWordCount());
+    if (grid.hasCosts()) m_costs.assign(grid.costData(), grid.costData() + grid.size());
+    else m_costs.clear();
+    m_version = grid.version();
+}
+
+void MapSnapshot::clear() {
+    m_rows = m_cols = 0;
+    m_version = 0;
+    m_walls.clear();
+    m_costs.clear();
+}
+
+bool MapSnapshot::diff(const GridMap &grid, std::size_t limit, std::vector<int> &changed) const {
+    changed.clear();
+    const std::size_t n = std::size_t(grid.size());
+    diffWalls(grid.wallWords(), m_walls.data(), m_walls.size(), limit, changed);
+    if (grid.hasCosts() && !m_costs.empty()) {
+        diffBytes(grid.costData(), m_costs.data(), n, limit, changed);
+    } else if (grid.hasCosts() != !m_costs.empty()) {
+        // One side has no cost layer: compare against unit costs
+        for (int i = 0; i < grid.size() && changed.size() <= limit; ++i)
+            if (grid.cost(i) != cost(i)) changed.push_back(i);
+    }
+    if (changed.size() > limit) return false;
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    return true;
+}
+
+void MapSnapshot::apply(const GridMap &grid, const std::vector<int> &changed) {
+    if (grid.hasCosts() != !m_costs.empty()) { assign(grid); return; }
+    for (int i : changed) {
+        const std::uint64_t bit = std::uint64_t(1) << (i & 63);
+        std::uint64_t &word = m_walls[std::size_t(i) >> 6];
+        word = grid.isWall(i) ? word | bit : word & ~bit;
+        if (!m_costs.empty()) m_costs[std::size_t(i)] = grid.cost(i);
+    }
+    m_version = grid.version();
+}
+
+} // namespace pathfinding
@@ -0,0 +1,324 @@
+#include "Core/ParallelBfs.hpp"
+#include "Core/BitOps.hpp"
+#include "Core/ThreadPool.hpp"
+#include "SearchInternal.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+// Frontier cells per top-down task / bitmap words (64 cells each) per bottom-up task
+constexpr std::size_t kFrontierChunk = 1024;
+constexpr std::size_t kWordChunk = 64;
+
+/**
+ * Bitmaps and level buffers of a run, kept per calling thread between runs
+ * (the distances live in a SearchContext), so repeated queries only refill
+ * them. visited holds visitedWords words, which may be more than a run uses.
+ */
+struct LevelBuffers {
+    std::unique_ptr<std::atomic<std::uint64_t>[]> visited;
+    std::size_t visitedWords = 0;
+    std::vector<std::uint64_t> frontierBits; // current level, bottom-up only
+    std::vector<std::vector<int>> next;      // per worker
+    std::vector<int> frontier;
+
+    std::size_t memoryBytes() const {
+        std::size_t bytes = (visitedWords + frontierBits.capacity()) * sizeof(std::uint64_t)
+            + frontier.capacity() * sizeof(int);
+        for (const auto &level : next) bytes += level.capacity() * sizeof(int);
+        return bytes;
+    }
+};
+
+LevelBuffers &threadBuffers() {
+    thread_local LevelBuffers buffers;
+    return buffers;
+}
+
+/**
+ * State of one level-synchronous run. Bottom-up levels test parents against a
+ * bitmap of the current frontier, which is read-only while the level runs;
+ * the pool's end-of-run handshake orders one level's writes before the next
+ * level's reads. Each cell's distance is written by the one worker that
+ * claimed it, into its own record of the context.
+ */
+class LevelSyncBfs {
+public:
+    LevelSyncBfs(const GridMap &grid, ThreadPool &pool, const ParallelBfsOptions &options, SearchContext &context,
+                 LevelBuffers &buffers)
+        : m_grid(grid),
+          m_pool(pool),
+          m_options(options),
+          m_context(context),
+          m_words((std::size_t(grid.size()) + 63) / 64),
+          m_frontierBits(buffers.frontierBits),
+          m_next(buffers.next),
+          m_frontier(buffers.frontier)
+    {
+        if (buffers.visitedWords < m_words) {
+            buffers.visited.reset(new std::atomic<std::uint64_t>[m_words]);
+            buffers.visitedWords = m_words;
+        }
+        m_visited = buffers.visited.get();
+        m_frontierBits.assign(m_words, 0);
+        m_next.resize(std::size_t(pool.size()));
+        context.reset(grid.size());
+        // Walls start out visited, so neither direction ever claims them; the packed walls
+        // are copied a word at a time, and the bits past the last cell are set too
+        const std::uint64_t *walls = grid.wallWords();
+        const unsigned tail = unsigned(grid.size() & 63);
+        for (std::size_t w = 0; w < m_words; ++w) {
+            std::uint64_t bits = walls[w];
+            if (w + 1 == m_words && tail != 0) bits |= ~std::uint64_t(0) << tail;
+            m_visited[w].store(bits, std::memory_order_relaxed);
+            m_unvisited += 64 - popcount64(bits);
+        }
+    }
+
+    /**
+     * Runs from source until the frontier is empty or, if target >= 0, until the
+     * level holding target has been reported. Returns false when aborted.
+     */
+    bool run(int source, int target, SearchObserver *observer, SearchStats &searchStats) {
+        std::vector<int> &frontier = m_frontier;
+        frontier.assign(1, source);
+        m_context.setDist(source, 0);
+        claim(source);
+
+        bool bottomUp = false;
+        for (int level = 0; !frontier.empty(); ++level) {
+            if (observer && observer->shouldAbort()) return false;
+            searchStats.nodesExpanded += std::int64_t(frontier.size());
+            m_stats.widestLevel = std::max(m_stats.widestLevel, std::int64_t(frontier.size()));
+            if (observer)
+                for (int cell : frontier) observer->onVisit(cell);
+            if (target >= 0 && m_context.dist(target) == level) break;
+
+            const std::int64_t size = std::int64_t(frontier.size());
+            if (m_options.directionOptimizing && level > 0) {
+                if (!bottomUp && size * m_options.alpha > m_unvisited)
+                    bottomUp = true;
+                else if (bottomUp && size * m_options.beta < std::int64_t(m_grid.size()))
+                    bottomUp = false;
+            }
+
+            for (auto &next : m_next) next.clear();
+            if (bottomUp) {
+                for (int cell : frontier) m_frontierBits[std::size_t(cell) >> 6] |= std::uint64_t(1) << (cell & 63);
+                bottomUpLevel(level);
+                for (int cell : frontier) m_frontierBits[std::size_t(cell) >> 6] = 0;
+                ++m_stats.bottomUpLevels;
+            } else {
+                topDownLevel(frontier, level);
+            }
+
+            frontier.clear();
+            for (const auto &next : m_next) frontier.insert(frontier.end(), next.begin(), next.end());
+            m_unvisited -= std::int64_t(frontier.size());
+            searchStats.nodesGenerated += std::int64_t(frontier.size());
+            m_stats.cellsReached += std::int64_t(frontier.size());
+            m_stats.levels = level + 1;
+        }
+        return true;
+    }
+
+    const DistanceFieldStats &stats() const { return m_stats; }
+
+private:
+    // Marks source visited (it may be a wall, like in bfs())
+    void claim(int cell) {
+        m_visited[std::size_t(cell) >> 6].fetch_or(std::uint64_t(1) << (cell & 63), std::memory_order_relaxed);
+        ++m_stats.cellsReached;
+        if (!m_grid.isWall(cell)) --m_unvisited;
+    }
+
+    // Every frontier cell claims its unvisited neighbors; fetch_or decides races
+    void topDownLevel(const std::vector<int> &frontier, int level) {
+        const std::size_t count = frontier.size();
+        const int tasks = int((count + kFrontierChunk - 1) / kFrontierChunk);
+        m_pool.run(tasks, [&](int task, int worker) {
+            auto &next = m_next[std::size_t(worker)];
+            const std::size_t begin = std::size_t(task) * kFrontierChunk;
+            const std::size_t end = std::min(count, begin + kFrontierChunk);
+            for (std::size_t i = begin; i < end; ++i) {
+                forEachNeighbor(m_grid, frontier[i], [&](int nb) {
+                    auto &word = m_visited[std::size_t(nb) >> 6];
+                    const std::uint64_t bit = std::uint64_t(1) << (nb & 63);
+                    if (word.load(std::memory_order_relaxed) & bit) return;
+                    if (word.fetch_or(bit, std::memory_order_relaxed) & bit) return;
+                    m_context.setDist(nb, level + 1);
+                    next.push_back(nb);
+                });
+            }
+        });
+    }
+
+    // Every unvisited cell looks for a neighbor in the current level; tasks own
+    // whole bitmap words, so each word has a single writer
+    void bottomUpLevel(int level) {
+        const int tasks = int((m_words + kWordChunk - 1) / kWordChunk);
+        m_pool.run(tasks, [&](int task, int worker) {
+            auto &next = m_next[std::size_t(worker)];
+            const std::size_t begin = std::size_t(task) * kWordChunk;
+            const std::size_t end = std::min(m_words, begin + kWordChunk);
+            for (std::size_t w = begin; w < end; ++w) {
+                std::uint64_t open = ~m_visited[w].load(std::memory_order_relaxed);
+                std::uint64_t found = 0;
+                while (open) {
+                    const int bit = countTrailingZeros64(open);
+                    open &= open - 1;
+                    const int cell = int(w * 64) + bit;
+                    if (!hasFrontierNeighbor(cell)) continue;
+                    m_context.setDist(cell, level + 1);
+                    found |= std::uint64_t(1) << bit;
+                    next.push_back(cell);
+                }
+                if (found) m_visited[w].fetch_or(found, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    bool inFrontier(int cell) const {
+        return (m_frontierBits[std::size_t(cell) >> 6] >> (cell & 63)) & 1u;
+    }
+
+    // Walls are not skipped here: the source may be one
+    bool hasFrontierNeighbor(int cell) const {
+        const int cols = m_grid.cols();
+        const int r = cell / cols, c = cell - r * cols;
+        return (r > 0 && inFrontier(cell - cols))
+            || (r + 1 < m_grid.rows() && inFrontier(cell + cols))
+            || (c > 0 && inFrontier(cell - 1))
+            || (c + 1 < cols && inFrontier(cell + 1));
+    }
+
+    const GridMap &m_grid;
+    ThreadPool &m_pool;
+    ParallelBfsOptions m_options;
+    SearchContext &m_context;
+    std::size_t m_words;
+    std::atomic<std::uint64_t> *m_visited = nullptr;
+    std::vector<std::uint64_t> &m_frontierBits;
+    std::vector<std::vector<int>> &m_next;
+    std::vector<int> &m_frontier;
+    std::int64_t m_unvisited = 0; // free cells not reached yet
+    DistanceFieldStats m_stats;
+};
+
+} // namespace
+
+std::vector<int> bfsDistanceField(const GridMap &grid, int source) {
+    std::vector<int> dist(std::size_t(grid.size()), Unreachable);
+    if (source < 0 || source >= grid.size()) return dist;
+
+    std::vector<int> queue;
+    queue.reserve(std::size_t(grid.size()));
+    queue.push_back(source);
+    dist[source] = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const int cur = queue[head];
+        forEachNeighbor(grid, cur, [&](int nb) {
+            if (dist[nb] != Unreachable) return;
+            dist[nb] = dist[cur] + 1;
+            queue.push_back(nb);
+        });
+    }
+    return dist;
+}
+
+std::vector<int> parallelBfsDistanceField(const GridMap &grid, int source, const ParallelBfsOptions &options,
+                                          DistanceFieldStats *stats) {
+    if (source < 0 || source >= grid.size()) return std::vector<int>(std::size_t(grid.size()), Unreachable);
+    const auto t0 = Clock::now();
+
+    SearchContext &context = threadContext();
+    LevelSyncBfs bfs(grid, ThreadPool::shared(options.threads), options, context, threadBuffers());
+    SearchStats searchStats;
+    bfs.run(source, -1, nullptr, searchStats);
+    std::vector<int> dist(std::size_t(grid.size()));
+    for (int i = 0; i < grid.size(); ++i) {
+        const int d = context.dist(i);
+        dist[std::size_t(i)] = d == SearchContext::Infinity ? Unreachable : d;
+    }
+    if (stats) {
+        *stats = bfs.stats();
+        stats->elapsedMs = elapsedSince(t0);
+    }
+    return dist;
+}
+
+namespace {
+
+/**
+ * Every claimed cell joins one frontier and is expanded with it, so the
+ * counters are taken per level: no stale pops, and the widest level is the
+ * peak open list.
+ */
+template <typename Counters>
+SearchResult parallelBfsWith(Counters &counters, SearchContext &context, const GridMap &grid, int start, int target,
+                             SearchObserver *observer, const SearchOptions &options) {
+    SearchResult result;
+    const auto t0 = Clock::now();
+
+    ParallelBfsOptions bfsOptions;
+    bfsOptions.threads = options.threads;
+    LevelBuffers &buffers = threadBuffers();
+    const std::size_t bufferBytes = buffers.memoryBytes();
+    LevelSyncBfs bfs(grid, ThreadPool::shared(bfsOptions.threads), bfsOptions, context, buffers);
+    const bool finished = bfs.run(start, target, observer, result.stats);
+    counters.counted(result.stats.nodesGenerated + 1, result.stats.nodesExpanded,
+                     std::size_t(bfs.stats().widestLevel));
+    if (buffers.memoryBytes() > bufferBytes) counters.allocated(buffers.memoryBytes() - bufferBytes);
+    if (!finished) {
+        result.aborted = true;
+    } else if (context.dist(target) != INF) {
+        // Walk down the distances; any neighbor one step closer is on a shortest path
+        const auto tPath = counters.pathStart();
+        const int length = context.dist(target);
+        result.path.resize(std::size_t(length) + 1);
+        int at = target;
+        for (int d = length; d > 1; --d) {
+            result.path[std::size_t(d)] = at;
+            int prev = -1;
+            forEachNeighbor(grid, at, [&](int nb) {
+                if (prev == -1 && context.dist(nb) == d - 1) prev = nb;
+            });
+            at = prev;
+        }
+        if (length > 0) result.path[1] = at;
+        result.path[0] = start; // the only cell at 0, and possibly a wall
+        counters.pathBuilt(tPath);
+        counters.allocated(result.path.capacity() * sizeof(int));
+        result.found = true;
+        result.pathCost = pathCostOf(grid, result.path);
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+} // namespace
+
+SearchResult parallelBfs(const GridMap &grid, int start, int target, SearchContext &context,
+                         SearchObserver *observer, const SearchOptions &options) {
+    if (!validQuery(grid, start, target)) return SearchResult();
+    return withCounters(options, [&](auto counters) {
+        counters.trackContext(context);
+        SearchResult result = parallelBfsWith(counters, context, grid, start, target, observer, options);
+        counters.settleContext(context);
+        counters.report(result.stats);
+        return result;
+    });
+}
+
+SearchResult parallelBfs(const GridMap &grid, int start, int target, SearchObserver *observer,
+                         const SearchOptions &options) {
+    return parallelBfs(grid, start, target, threadContext(), observer, options);
+}
+
+} // namespace pathfinding
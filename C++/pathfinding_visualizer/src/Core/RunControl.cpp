@@ -0,0 +1,16 @@
+#include "Core/RunControl.hpp"
+
+namespace pathfinding {
+
+bool RunControl::begin(std::uint64_t id) {
+    m_current.store(id);
+    return m_cancelledUpTo.load() < id;
+}
+
+void RunControl::cancel(std::uint64_t upToId) {
+    // Ids only ever grow, so keep the largest one asked for
+    std::uint64_t seen = m_cancelledUpTo.load(std::memory_order_relaxed);
+    while (seen < upToId && !m_cancelledUpTo.compare_exchange_weak(seen, upToId)) {}
+}
+
+} // namespace pathfinding
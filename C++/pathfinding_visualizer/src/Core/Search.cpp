@@ -0,0 +1,345 @@
+#include "Core/Search.hpp"
+#include "Core/AnyAngle.hpp"
+#include "Core/Bidirectional.hpp"
+#include "Core/ComponentMap.hpp"
+#include "Core/DStarLite.hpp"
+#include "Core/FlowField.hpp"
+#include "Core/HierarchicalGraph.hpp"
+#include "Core/JumpPointSearch.hpp"
+#include "Core/ParallelBfs.hpp"
+#include "SearchInternal.hpp"
+
+namespace pathfinding {
+
+namespace {
+
+using namespace detail;
+
+/**
+ * Dijkstra with lazy deletion: stale open-list entries are skipped when popped.
+ * Entering a cell costs grid.cost(cell), times the step weight of Moves.
+ */
+template <typename Moves, typename OpenList, typename Counters>
+SearchResult dijkstraWith(OpenList &open, Counters &counters, SearchContext &context, const GridMap &grid, int start,
+                          int target, SearchObserver *observer) {
+    SearchResult result;
+    const auto t0 = Clock::now();
+
+    context.reset(grid.size());
+    context.setDist(start, 0);
+    context.setParent(start, -1);
+    open.push(0, 0, start);
+    counters.pushed(open.size());
+
+    while (!open.empty()) {
+        if (observer && observer->shouldAbort()) { result.aborted = true; break; }
+        const OpenEntry top = open.pop();
+        counters.popped();
+        const int d = top.f, cur = top.cell;
+        if (d != context.dist(cur)) { counters.stale(); continue; }
+
+        ++result.stats.nodesExpanded;
+        if (observer) observer->onVisit(cur);
+
+        if (cur == target) break;
+
+        Moves::forEach(grid, cur, [&](int nb, int weight) {
+            const int nd = d + weight * grid.cost(nb);
+            if (nd < context.dist(nb)) {
+                context.setDist(nb, nd);
+                context.setParent(nb, cur);
+                open.push(nd, 0, nb);
+                counters.pushed(open.size());
+                ++result.stats.nodesGenerated;
+            }
+        });
+    }
+
+    if (!result.aborted && context.dist(target) != INF) {
+        const auto tPath = counters.pathStart();
+        reconstructPath(context, target, result.path);
+        counters.pathBuilt(tPath);
+        counters.allocated(result.path.capacity() * sizeof(int));
+        result.found = true;
+        result.pathCost = context.dist(target);
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+/**
+ * A* with the obstacle-free distance of Moves (Manhattan or octile) scaled by
+ * the map's minimum cell cost, which keeps it admissible and consistent, so
+ * closed cells are never re-expanded.
+ * Heaps break f ties on the smaller h (closer to target).
+ */
+template <typename Moves, typename OpenList, typename Counters>
+SearchResult aStarWith(OpenList &open, Counters &counters, SearchContext &context, const GridMap &grid, int start,
+                       int target, SearchObserver *observer) {
+    SearchResult result;
+    const auto t0 = Clock::now();
+
+    context.reset(grid.size());
+    const int hScale = grid.minCost();
+    context.setDist(start, 0);
+    context.setParent(start, -1);
+    const int h0 = Moves::distance(grid, start, target) * hScale;
+    open.push(h0, h0, start);
+    counters.pushed(open.size());
+
+    while (!open.empty()) {
+        if (observer && observer->shouldAbort()) { result.aborted = true; break; }
+        const int cur = open.pop().cell;
+        counters.popped();
+        if (context.closed(cur)) { counters.stale(); continue; }
+        context.setClosed(cur);
+
+        ++result.stats.nodesExpanded;
+        if (observer) observer->onVisit(cur);
+
+        if (cur == target) break;
+
+        const int g = context.dist(cur);
+        Moves::forEach(grid, cur, [&](int nb, int weight) {
+            const int tentative = g + weight * grid.cost(nb);
+            if (tentative < context.dist(nb)) {
+                context.setDist(nb, tentative);
+                context.setParent(nb, cur);
+                const int h = Moves::distance(grid, nb, target) * hScale;
+                open.push(tentative + h, h, nb);
+                counters.pushed(open.size());
+                ++result.stats.nodesGenerated;
+            }
+        });
+    }
+
+    if (!result.aborted && context.dist(target) != INF) {
+        const auto tPath = counters.pathStart();
+        reconstructPath(context, target, result.path);
+        counters.pathBuilt(tPath);
+        counters.allocated(result.path.capacity() * sizeof(int));
+        result.found = true;
+        result.pathCost = context.dist(target);
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+/**
+ * BFS: expands cells in FIFO order, the first time target is popped its path has
+ * the fewest steps. Cell costs are ignored while searching but counted in pathCost.
+ */
+template <typename Moves, typename Counters>
+SearchResult bfsWith(Counters &counters, SearchContext &context, const GridMap &grid, int start, int target,
+                     SearchObserver *observer, Connectivity connectivity) {
+    SearchResult result;
+    const auto t0 = Clock::now();
+
+    // closed marks cells already queued
+    context.reset(grid.size());
+    std::vector<int> &queue = context.queue();
+    queue.push_back(start);
+    counters.pushed(1);
+    context.setClosed(start);
+    context.setParent(start, -1);
+
+    std::size_t head = 0;
+    while (head < queue.size()) {
+        if (observer && observer->shouldAbort()) { result.aborted = true; break; }
+        const int cur = queue[head++];
+        counters.popped();
+        ++result.stats.nodesExpanded;
+        if (observer) observer->onVisit(cur);
+
+        if (cur == target) break;
+
+        Moves::forEach(grid, cur, [&](int nb, int) {
+            if (context.closed(nb)) return;
+            context.setClosed(nb);
+            context.setParent(nb, cur);
+            queue.push_back(nb);
+            counters.pushed(queue.size() - head);
+            ++result.stats.nodesGenerated;
+        });
+    }
+
+    if (!result.aborted && context.closed(target)) {
+        const auto tPath = counters.pathStart();
+        reconstructPath(context, target, result.path);
+        counters.pathBuilt(tPath);
+        counters.allocated(result.path.capacity() * sizeof(int));
+        result.found = true;
+        result.pathCost = pathCostOf(grid, result.path, connectivity);
+    }
+    result.stats.elapsedMs = elapsedSince(t0);
+    return result;
+}
+
+} // namespace
+
+SearchContext &detail::threadContext() {
+    thread_local SearchContext context;
+    return context;
+}
+
+const char *algorithmName(Algorithm algo) {
+    switch (algo) {
+    case Algorithm::BFS: return "BFS";
+    case Algorithm::Dijkstra: return "Dijkstra";
+    case Algorithm::AStar: return "A*";
+    case Algorithm::JPS: return "JPS";
+    case Algorithm::BlockJPS: return "JPS (block)";
+    case Algorithm::BidirectionalBFS: return "Bidirectional BFS";
+    case Algorithm::BidirectionalAStar: return "Bidirectional A*";
+    case Algorithm::ParallelBFS: return "Parallel BFS";
+    case Algorithm::FlowField: return "Flow field";
+    case Algorithm::DStarLite: return "D* Lite";
+    case Algorithm::HPA: return "HPA*";
+    case Algorithm::ThetaStar: return "Theta*";
+    case Algorithm::LazyThetaStar: return "Lazy Theta*";
+    }
+    return "?";
+}
+
+SearchResult bfs(const GridMap &grid, int start, int target, SearchContext &context, SearchObserver *observer,
+                 const SearchOptions &options) {
+    if (!validQuery(grid, start, target)) return SearchResult();
+    // FIFO queue, so only the movement model is selected
+    return withMoves(options, [&](auto moves) {
+        return withCounters(options, [&](auto counters) {
+            counters.trackContext(context);
+            SearchResult result = bfsWith<decltype(moves)>(counters, context, grid, start, target, observer,
+                                                           options.connectivity);
+            counters.settleContext(context);
+            counters.report(result.stats);
+            return result;
+        });
+    });
+}
+
+const char *cornerCuttingName(CornerCutting corners) {
+    switch (corners) {
+    case CornerCutting::Never: return "never";
+    case CornerCutting::OneSide: return "one side";
+    case CornerCutting::Always: return "always";
+    }
+    return "?";
+}
+
+bool supportsEightConnectivity(Algorithm algo) {
+    return algo == Algorithm::BFS || algo == Algorithm::Dijkstra || algo == Algorithm::AStar;
+}
+
+bool isAnyAngle(Algorithm algo) {
+    return algo == Algorithm::ThetaStar || algo == Algorithm::LazyThetaStar;
+}
+
+const char *queueKindName(QueueKind kind) {
+    switch (kind) {
+    case QueueKind::BinaryHeap: return "binary";
+    case QueueKind::QuaternaryHeap: return "4-ary";
+    case QueueKind::BucketQueue: return "bucket";
+    case QueueKind::RadixHeap: return "radix";
+    }
+    return "?";
+}
+
+SearchResult dijkstra(const GridMap &grid, int start, int target, SearchContext &context, SearchObserver *observer,
+                      const SearchOptions &options) {
+    if (!validQuery(grid, start, target)) return SearchResult();
+    return withMoves(options, [&](auto moves) {
+        using Moves = decltype(moves);
+        // f grows by at most the entered cell's weighted cost per edge
+        const int span = grid.maxCost() * Moves::MaxWeight + 1;
+        return withCounters(options, [&](auto counters) {
+            counters.trackContext(context);
+            SearchResult result = withOpenList(context, options, span, [&](auto &open) {
+                return dijkstraWith<Moves>(open, counters, context, grid, start, target, observer);
+            });
+            counters.settleContext(context);
+            counters.report(result.stats);
+            return result;
+        });
+    });
+}
+
+SearchResult aStar(const GridMap &grid, int start, int target, SearchContext &context, SearchObserver *observer,
+                   const SearchOptions &options) {
+    if (!validQuery(grid, start, target)) return SearchResult();
+    return withMoves(options, [&](auto moves) {
+        using Moves = decltype(moves);
+        // f grows by at most one weighted cell cost plus one scaled heuristic step
+        const int span = (grid.maxCost() + grid.minCost()) * Moves::MaxWeight + 1;
+        return withCounters(options, [&](auto counters) {
+            counters.trackContext(context);
+            SearchResult result = withOpenList(context, options, span, [&](auto &open) {
+                return aStarWith<Moves>(open, counters, context, grid, start, target, observer);
+            });
+            counters.settleContext(context);
+            counters.report(result.stats);
+            return result;
+        });
+    });
+}
+
+// Callers without a context of their own share one per thread
+SearchResult bfs(const GridMap &grid, int start, int target, SearchObserver *observer,
+                 const SearchOptions &options) {
+    return bfs(grid, start, target, threadContext(), observer, options);
+}
+
+SearchResult dijkstra(const GridMap &grid, int start, int target, SearchObserver *observer,
+                      const SearchOptions &options) {
+    return dijkstra(grid, start, target, threadContext(), observer, options);
+}
+
+SearchResult aStar(const GridMap &grid, int start, int target, SearchObserver *observer,
+                   const SearchOptions &options) {
+    return aStar(grid, start, target, threadContext(), observer, options);
+}
+
+SearchResult runSearch(Algorithm algo, const GridMap &grid, int start, int target,
+                       SearchObserver *observer, const SearchOptions &options) {
+    return runSearch(algo, grid, start, target, threadContext(), observer, options);
+}
+
+/**
+ * Pairs in different regions of the map are answered from the per-thread
+ * ComponentMap before any search starts, so an unreachable target costs an
+ * O(1) lookup (plus the label repair after an edit) instead of a flood of
+ * the start's whole region.
+ */
+SearchResult runSearch(Algorithm algo, const GridMap &grid, int start, int target, SearchContext &context,
+                       SearchObserver *observer, const SearchOptions &options) {
+    if (options.reachabilityCheck && validQuery(grid, start, target)) {
+        const auto t0 = Clock::now();
+        const ComponentMap &components = componentsFor(grid, options, observer);
+        if (components.empty() || !components.reachable(start, target)) {
+            SearchResult result;
+            result.aborted = components.empty(); // only an aborted update leaves a non-empty map unlabeled
+            result.stats.elapsedMs = elapsedSince(t0);
+            return withCounters(options, [&](auto counters) {
+                counters.report(result.stats);
+                return result;
+            });
+        }
+    }
+    switch (algo) {
+    case Algorithm::BFS: return bfs(grid, start, target, context, observer, options);
+    case Algorithm::Dijkstra: return dijkstra(grid, start, target, context, observer, options);
+    case Algorithm::AStar: return aStar(grid, start, target, context, observer, options);
+    case Algorithm::JPS: return jumpPointSearch(grid, start, target, context, observer, options);
+    case Algorithm::BlockJPS: return blockJumpPointSearch(grid, start, target, context, observer, options);
+    case Algorithm::BidirectionalBFS: return bidirectionalBfs(grid, start, target, context, observer, options);
+    case Algorithm::BidirectionalAStar: return bidirectionalAStar(grid, start, target, context, observer, options);
+    case Algorithm::ParallelBFS: return parallelBfs(grid, start, target, context, observer, options);
+    case Algorithm::FlowField: return flowFieldSearch(grid, start, target, observer, options);
+    case Algorithm::DStarLite: return dStarLiteSearch(grid, start, target, observer, options);
+    case Algorithm::HPA: return hpaSearch(grid, start, target, observer, options);
+    case Algorithm::ThetaStar: return thetaStar(grid, start, target, context, observer, options);
+    case Algorithm::LazyThetaStar: return lazyThetaStar(grid, start, target, context, observer, options);
+    }
+    return SearchResult();
+}
+
+} // namespace pathfinding
@@ -0,0 +1,45 @@
+#include "Core/SearchContext.hpp"
+
+#include <algorithm>
+
+namespace pathfinding {
+
+void SearchContext::reset(int cells) {
+    const std::size_t n = std::size_t(std::max(cells, 0));
+    // New records start at stamp 0, which is never a live generation
+    if (m_nodes.size() != n) m_nodes.resize(n, Node{0, Infinity, -1});
+    m_generation += 2;
+    if (m_generation == 0) {
+        // Wrapped after 2^31 queries: old stamps could look current again
+        std::fill(m_nodes.begin(), m_nodes.end(), Node{0, Infinity, -1});
+        m_generation = 2;
+    }
+}
+
+std::vector<int> &SearchContext::queue() {
+    m_queue.clear();
+    m_queue.reserve(m_nodes.size());
+    return m_queue;
+}
+
+BucketQueue &SearchContext::bucketQueue(int span) {
+    if (span > m_bucketSpan) {
+        m_bucket = BucketQueue(span);
+        m_bucketSpan = span;
+    }
+    m_bucket.clear();
+    return m_bucket;
+}
+
+SearchContext &SearchContext::backward() {
+    if (!m_backward) m_backward = std::make_unique<SearchContext>();
+    return *m_backward;
+}
+
+std::size_t SearchContext::memoryBytes() const {
+    return m_nodes.capacity() * sizeof(Node) + m_queue.capacity() * sizeof(int)
+        + m_binary.memoryBytes() + m_quaternary.memoryBytes() + m_radix.memoryBytes() + m_bucket.memoryBytes()
+        + (m_backward ? m_backward->memoryBytes() : 0);
+}
+
+} // namespace pathfinding
@@ -0,0 +1,272 @@
+#pragma once
+
+// Helpers shared by the search translation units; not part of the public API.
+
+#include "Core/GridMap.hpp"
+#include "Core/OpenList.hpp"
+#include "Core/Search.hpp"
+#include "Core/SearchContext.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace pathfinding {
+namespace detail {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int INF = SearchContext::Infinity;
+
+// Context of the callers that bring none; one per thread, shared by every search in the library
+SearchContext &threadContext();
+
+inline int manhattan(const GridMap &grid, int a, int b) {
+    return std::abs(grid.rowOf(a) - grid.rowOf(b)) + std::abs(grid.colOf(a) - grid.colOf(b));
+}
+
+/**
+ * Calls fn(neighbor) for every free 4-neighbor of cell.
+ * Rows are walked by +/- cols on the flat array, so no per-row indirection.
+ */
+template <typename Fn>
+inline void forEachNeighbor(const GridMap &grid, int cell, Fn &&fn) {
+    const int cols = grid.cols();
+    const int r = cell / cols;
+    const int c = cell - r * cols;
+    if (r + 1 < grid.rows() && !grid.isWall(cell + cols)) fn(cell + cols);
+    if (r > 0 && !grid.isWall(cell - cols)) fn(cell - cols);
+    if (c + 1 < cols && !grid.isWall(cell + 1)) fn(cell + 1);
+    if (c > 0 && !grid.isWall(cell - 1)) fn(cell - 1);
+}
+
+/**
+ * Movement models for the searches that take Connectivity, picked once per
+ * query so each gets its own inlined neighbor loop:
+ *   forEach(grid, cell, fn) calls fn(neighbor, weight) for every legal step,
+ *   where the step costs weight * grid.cost(neighbor);
+ *   distance(grid, a, b) is the obstacle-free path length in the same weights.
+ * FourWay keeps weight 1, so the 4-connected searches are unchanged.
+ */
+struct FourWay {
+    static constexpr int MaxWeight = 1;
+
+    template <typename Fn>
+    static void forEach(const GridMap &grid, int cell, Fn &&fn) {
+        forEachNeighbor(grid, cell, [&](int nb) { fn(nb, 1); });
+    }
+
+    static int distance(const GridMap &grid, int a, int b) { return manhattan(grid, a, b); }
+};
+
+template <CornerCutting Corners>
+struct EightWay {
+    static constexpr int MaxWeight = DiagonalStep;
+
+    template <typename Fn>
+    static void forEach(const GridMap &grid, int cell, Fn &&fn) {
+        const int cols = grid.cols();
+        const int r = cell / cols;
+        const int c = cell - r * cols;
+        const bool down = r + 1 < grid.rows(), up = r > 0, right = c + 1 < cols, left = c > 0;
+        const bool openDown = down && !grid.isWall(cell + cols);
+        const bool openUp = up && !grid.isWall(cell - cols);
+        const bool openRight = right && !grid.isWall(cell + 1);
+        const bool openLeft = left && !grid.isWall(cell - 1);
+        if (openDown) fn(cell + cols, StraightStep);
+        if (openUp) fn(cell - cols, StraightStep);
+        if (openRight) fn(cell + 1, StraightStep);
+        if (openLeft) fn(cell - 1, StraightStep);
+
+        auto diagonal = [&](bool inside, bool sideA, bool sideB, int nb) {
+            if (!inside || grid.isWall(nb)) return;
+            if constexpr (Corners == CornerCutting::Never) {
+                if (!sideA || !sideB) return;
+            } else if constexpr (Corners == CornerCutting::OneSide) {
+                if (!sideA && !sideB) return;
+            }
+            fn(nb, DiagonalStep);
+        };
+        diagonal(down && right, openDown, openRight, cell + cols + 1);
+        diagonal(down && left, openDown, openLeft, cell + cols - 1);
+        diagonal(up && right, openUp, openRight, cell - cols + 1);
+        diagonal(up && left, openUp, openLeft, cell - cols - 1);
+    }
+
+    // Octile distance
+    static int distance(const GridMap &grid, int a, int b) {
+        const int dr = std::abs(grid.rowOf(a) - grid.rowOf(b));
+        const int dc = std::abs(grid.colOf(a) - grid.colOf(b));
+        const int diagonals = std::min(dr, dc);
+        return diagonals * DiagonalStep + (std::max(dr, dc) - diagonals) * StraightStep;
+    }
+};
+
+// Calls fn(movementModel) with the model options select
+template <typename Fn>
+SearchResult withMoves(const SearchOptions &options, Fn &&fn) {
+    if (options.connectivity == Connectivity::Eight) {
+        switch (options.corners) {
+        case CornerCutting::OneSide: return fn(EightWay<CornerCutting::OneSide>());
+        case CornerCutting::Always: return fn(EightWay<CornerCutting::Always>());
+        case CornerCutting::Never: break;
+        }
+        return fn(EightWay<CornerCutting::Never>());
+    }
+    return fn(FourWay());
+}
+
+inline bool validQuery(const GridMap &grid, int start, int target) {
+    return !grid.empty()
+        && start >= 0 && start < grid.size()
+        && target >= 0 && target < grid.size();
+}
+
+inline void reconstructPath(const std::vector<int> &parent, int target, std::vector<int> &path) {
+    path.clear();
+    for (int at = target; at != -1; at = parent[at])
+        path.push_back(at);
+    std::reverse(path.begin(), path.end());
+}
+
+inline void reconstructPath(const SearchContext &context, int target, std::vector<int> &path) {
+    path.clear();
+    for (int at = target; at != -1; at = context.parent(at))
+        path.push_back(at);
+    std::reverse(path.begin(), path.end());
+}
+
+// Sum of the costs of every cell entered after the start
+inline int pathCostOf(const GridMap &grid, const std::vector<int> &path) {
+    int cost = 0;
+    for (std::size_t i = 1; i < path.size(); ++i)
+        cost += grid.cost(path[i]);
+    return cost;
+}
+
+// Same with diagonal steps weighted as the 8-connected searches do
+inline int pathCostOf(const GridMap &grid, const std::vector<int> &path, Connectivity connectivity) {
+    if (connectivity == Connectivity::Four) return pathCostOf(grid, path);
+    int cost = 0;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        const bool diagonal = grid.rowOf(path[i]) != grid.rowOf(path[i - 1])
+            && grid.colOf(path[i]) != grid.colOf(path[i - 1]);
+        cost += grid.cost(path[i]) * (diagonal ? DiagonalStep : StraightStep);
+    }
+    return cost;
+}
+
+inline double elapsedSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+/**
+ * Instrumentation policies of the search loops, picked once per query like
+ * the movement model. The loops call
+ *   pushed(openSize) after every push, popped() after every pop and stale()
+ *   for popped entries they skip, or counted(pushes, pops, peakOpen) for a
+ *   whole batch (a BFS level);
+ *   trackContext(context) before a query and settleContext(context) after it,
+ *   allocated(bytes) for scratch memory a query allocates itself;
+ *   pathStart() and pathBuilt(t) around the path reconstruction, or
+ *   pathTook(ms) when it was timed elsewhere;
+ *   report(stats) once stats.elapsedMs is final.
+ * Every NoCounters hook is an empty inline function, so a query without
+ * SearchOptions::counters compiles to the uninstrumented loop.
+ */
+struct NoCounters {
+    static constexpr bool Enabled = false;
+
+    void pushed(std::size_t) {}
+    void popped() {}
+    void stale() {}
+    void trackContext(const SearchContext &) {}
+    void settleContext(const SearchContext &) {}
+    void allocated(std::size_t) {}
+    void counted(std::int64_t, std::int64_t, std::size_t) {}
+    Clock::time_point pathStart() const { return {}; }
+    void pathBuilt(Clock::time_point) {}
+    void pathTook(double) {}
+    void report(SearchStats &) const {}
+};
+
+class RunCounters {
+public:
+    static constexpr bool Enabled = true;
+
+    void pushed(std::size_t openSize) {
+        ++m_counters.pushes;
+        if (std::int64_t(openSize) > m_counters.peakOpen) m_counters.peakOpen = std::int64_t(openSize);
+    }
+    void popped() { ++m_counters.pops; }
+    void stale() { ++m_counters.stalePops; }
+    void counted(std::int64_t pushes, std::int64_t pops, std::size_t peakOpen) {
+        m_counters.pushes += pushes;
+        m_counters.pops += pops;
+        if (std::int64_t(peakOpen) > m_counters.peakOpen) m_counters.peakOpen = std::int64_t(peakOpen);
+    }
+
+    void trackContext(const SearchContext &context) { m_contextBytes = context.memoryBytes(); }
+    void settleContext(const SearchContext &context) {
+        // Buffers only grow, except a bucket queue rebuilt for a wider span
+        const std::size_t bytes = context.memoryBytes();
+        if (bytes > m_contextBytes) allocated(bytes - m_contextBytes);
+    }
+    void allocated(std::size_t bytes) { m_counters.bytesAllocated += std::int64_t(bytes); }
+
+    Clock::time_point pathStart() const { return Clock::now(); }
+    void pathBuilt(Clock::time_point t0) { pathTook(elapsedSince(t0)); }
+    void pathTook(double ms) { m_counters.pathMs += ms; }
+
+    void report(SearchStats &stats) const {
+        stats.counters = m_counters;
+        stats.counters.measured = true;
+        stats.counters.searchMs = stats.elapsedMs - m_counters.pathMs;
+    }
+
+private:
+    SearchCounters m_counters;
+    std::size_t m_contextBytes = 0;
+};
+
+// Calls fn(counters) with the policy options select
+template <typename Fn>
+SearchResult withCounters(const SearchOptions &options, Fn &&fn) {
+    if (options.counters) return fn(RunCounters());
+    return fn(NoCounters());
+}
+
+/**
+ * Builds the open list selected in options and calls fn(openList).
+ * bucketSpan must exceed the largest f increase along one edge, which is
+ * what the bucket queue's circular window needs.
+ */
+template <typename Fn>
+SearchResult withOpenList(const SearchOptions &options, int bucketSpan, Fn &&fn) {
+    switch (options.queue) {
+    case QueueKind::QuaternaryHeap: { QuaternaryHeap open; return fn(open); }
+    case QueueKind::BucketQueue: { BucketQueue open(bucketSpan); return fn(open); }
+    case QueueKind::RadixHeap: { RadixHeap open; return fn(open); }
+    case QueueKind::BinaryHeap: break;
+    }
+    BinaryHeap open;
+    return fn(open);
+}
+
+// Same, but hands out the (cleared) open list kept in context
+template <typename Fn>
+SearchResult withOpenList(SearchContext &context, const SearchOptions &options, int bucketSpan, Fn &&fn) {
+    switch (options.queue) {
+    case QueueKind::QuaternaryHeap: return fn(context.quaternaryHeap());
+    case QueueKind::BucketQueue: return fn(context.bucketQueue(bucketSpan));
+    case QueueKind::RadixHeap: return fn(context.radixHeap());
+    case QueueKind::BinaryHeap: break;
+    }
+    return fn(context.binaryHeap());
+}
+
+} // namespace detail
+} // namespace pathfinding
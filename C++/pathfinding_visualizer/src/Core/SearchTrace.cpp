@@ -0,0 +1,103 @@
+#include "Core/SearchTrace.hpp"
+#include "Core/MappedFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace pathfinding {
+
+namespace {
+
+const char kTraceMagic[4] = {'P', 'F', 'T', 'R'};
+const std::uint32_t kTraceVersion = 1;
+const std::size_t kTraceHeaderSize = 68;
+
+bool fail(std::string *error, const std::string &msg) {
+    if (error) *error = msg;
+    return false;
+}
+
+std::uint64_t readLE(const unsigned char *p, int bytes) {
+    std::uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+void writeLE(std::FILE *f, std::uint64_t v, int bytes) {
+    unsigned char b[8];
+    for (int i = 0; i < bytes; ++i) b[i] = static_cast<unsigned char>(v >> (8 * i));
+    std::fwrite(b, 1, std::size_t(bytes), f);
+}
+
+} // namespace
+
+void SearchTrace::finish(const SearchResult &result) {
+    found = result.found;
+    pathCost = result.pathCost;
+    stats = result.stats;
+    events.reserve(events.size() + result.path.size());
+    for (int cell : result.path) add(Path, cell);
+}
+
+bool loadTrace(const std::string &path, SearchTrace &out, std::string *error) {
+    MappedFile file;
+    if (!file.open(path, error)) return false;
+    if (file.size() < kTraceHeaderSize || std::memcmp(file.data(), kTraceMagic, 4) != 0)
+        return fail(error, path + " is not a PFTR trace");
+
+    const unsigned char *p = file.data();
+    if (readLE(p + 4, 4) != kTraceVersion) return fail(error, "unsupported PFTR version in " + path);
+    SearchTrace trace;
+    trace.rows = int(readLE(p + 8, 4));
+    trace.cols = int(readLE(p + 12, 4));
+    if (readLE(p + 16, 4) > std::uint64_t(Algorithm::LazyThetaStar)) return fail(error, "unknown algorithm in " + path);
+    trace.algorithm = Algorithm(readLE(p + 16, 4));
+    trace.start = int(std::int32_t(readLE(p + 20, 4)));
+    trace.target = int(std::int32_t(readLE(p + 24, 4)));
+    trace.found = readLE(p + 28, 4) != 0;
+    trace.pathCost = int(std::int32_t(readLE(p + 32, 4)));
+    trace.stats.nodesExpanded = std::int64_t(readLE(p + 36, 8));
+    trace.stats.nodesGenerated = std::int64_t(readLE(p + 44, 8));
+    const std::uint64_t elapsedBits = readLE(p + 52, 8);
+    std::memcpy(&trace.stats.elapsedMs, &elapsedBits, 8);
+    const std::uint64_t count = readLE(p + 60, 8);
+    if (trace.rows <= 0 || trace.cols <= 0 || std::int64_t(trace.rows) * trace.cols > SearchTrace::MaxCells)
+        return fail(error, "invalid dimensions in " + path);
+    if ((file.size() - kTraceHeaderSize) / 4 < count) return fail(error, "truncated PFTR trace " + path);
+
+    trace.events.resize(std::size_t(count));
+    std::memcpy(trace.events.data(), p + kTraceHeaderSize, std::size_t(count) * 4); // little-endian host assumed
+    const int cells = trace.rows * trace.cols;
+    for (std::uint32_t event : trace.events)
+        if (SearchTrace::kindOf(event) > SearchTrace::Path || SearchTrace::cellOf(event) >= cells)
+            return fail(error, "corrupt event in " + path);
+    out = std::move(trace);
+    return true;
+}
+
+bool saveTrace(const std::string &path, const SearchTrace &trace, std::string *error) {
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f) return fail(error, "cannot write " + path);
+
+    std::fwrite(kTraceMagic, 1, 4, f);
+    writeLE(f, kTraceVersion, 4);
+    writeLE(f, std::uint32_t(trace.rows), 4);
+    writeLE(f, std::uint32_t(trace.cols), 4);
+    writeLE(f, std::uint32_t(trace.algorithm), 4);
+    writeLE(f, std::uint32_t(trace.start), 4);
+    writeLE(f, std::uint32_t(trace.target), 4);
+    writeLE(f, trace.found ? 1 : 0, 4);
+    writeLE(f, std::uint32_t(trace.pathCost), 4);
+    writeLE(f, std::uint64_t(trace.stats.nodesExpanded), 8);
+    writeLE(f, std::uint64_t(trace.stats.nodesGenerated), 8);
+    std::uint64_t elapsedBits;
+    std::memcpy(&elapsedBits, &trace.stats.elapsedMs, 8);
+    writeLE(f, elapsedBits, 8);
+    writeLE(f, trace.events.size(), 8);
+    std::fwrite(trace.events.data(), 4, trace.events.size(), f);
+    const bool ok = std::ferror(f) == 0;
+    return (std::fclose(f) == 0 && ok) || fail(error, "write error on " + path);
+}
+
+} // namespace pathfinding
@@ -0,0 +1,140 @@
+#include "Core/ThreadPool.hpp"
+
+#include <map>
+#include <memory>
+
+namespace pathfinding {
+
+namespace {
+
+int resolveThreads(int threads) {
+    if (threads > 0) return threads;
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw ? int(hw) : 1;
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(int threads) {
+    const int count = resolveThreads(threads);
+    m_ranges.reset(new Range[std::size_t(count)]);
+    m_threads.reserve(std::size_t(count - 1));
+    for (int i = 1; i < count; ++i)
+        m_threads.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &t : m_threads) t.join();
+}
+
+void ThreadPool::run(int tasks, const std::function<void(int, int)> &fn) {
+    if (tasks <= 0) return;
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+    if (m_threads.empty() || tasks == 1) {
+        for (int t = 0; t < tasks; ++t) fn(t, 0);
+        return;
+    }
+    // fn is published before the ranges, so whoever takes a task sees it
+    m_fn.store(&fn);
+    m_pending.store(tasks);
+    const int workers = size();
+    for (int w = 0; w < workers; ++w) {
+        std::lock_guard<std::mutex> lock(m_ranges[w].mutex);
+        m_ranges[w].begin = int(std::int64_t(tasks) * w / workers);
+        m_ranges[w].end = int(std::int64_t(tasks) * (w + 1) / workers);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+        m_busy = int(m_threads.size());
+    }
+    m_wake.notify_all();
+    drain(0);
+
+    // Waiting for every worker, not just every task, keeps a late one from
+    // stealing while the next run() is still writing the ranges: the steal
+    // would land in its own range right before that is overwritten
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending.load() == 0 && m_busy == 0; });
+}
+
+// Runs own tasks front to back, then steals until every range is empty
+void ThreadPool::drain(int worker) {
+    int task;
+    while (takeOwn(worker, task) || steal(worker, task)) {
+        (*m_fn.load())(task, worker);
+        if (m_pending.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::takeOwn(int worker, int &task) {
+    Range &own = m_ranges[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.begin >= own.end) return false;
+    task = own.begin++;
+    return true;
+}
+
+/**
+ * Takes the upper half of the first non-empty range after our own. Only one
+ * range lock is held at a time; the stolen tasks are in neither range for a
+ * moment, which is harmless because completion is counted, not searched for.
+ */
+bool ThreadPool::steal(int worker, int &task) {
+    const int workers = size();
+    for (int i = 1; i < workers; ++i) {
+        Range &victim = m_ranges[(worker + i) % workers];
+        int begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin >= victim.end) continue;
+            end = victim.end;
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            victim.end = begin;
+        }
+        task = begin;
+        Range &own = m_ranges[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.begin = begin + 1;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(int worker) {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+        drain(worker);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0) m_done.notify_all();
+    }
+}
+
+ThreadPool &ThreadPool::shared(int threads) {
+    // Pools are kept for the life of the process, so a reference handed out
+    // earlier stays valid when another size is requested
+    static std::mutex mutex;
+    static std::map<int, std::unique_ptr<ThreadPool>> pools;
+    const int count = resolveThreads(threads);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &pool = pools[count];
+    if (!pool) pool = std::make_unique<ThreadPool>(count);
+    return *pool;
+}
+
+} // namespace pathfinding
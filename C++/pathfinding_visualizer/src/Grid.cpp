@@ -1,84 +1,281 @@
 #include "Grid.hpp"
-#include "Node.hpp"
+#include "GridItem.hpp"
+#include "Core/HierarchicalGraph.hpp"
 
+#include <QColor>
+#include <QGraphicsPathItem>
+#include <QPainterPath>
+#include <QPen>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsView>
-#include <QBrush>
 #include <QDebug>
 
 Grid::Grid(int rows, int cols, QObject *parent)
-    : QObject(parent), m_rows(rows), m_cols(cols), m_scene(new QGraphicsScene(this))
+    : QObject(parent), m_rows(0), m_cols(0), m_scene(new QGraphicsScene(this)), m_item(nullptr), m_polyline(nullptr),
+      m_brush(WallBrush), m_editable(true)
 {
-    const int cellSize = 22;
-    m_nodes.resize(m_rows);
-    for (int r = 0; r < m_rows; ++r) {
-        m_nodes[r].resize(m_cols);
-        for (int c = 0; c < m_cols; ++c) {
-            Node *n = new Node(r, c);
-            n->setRect(0,0,cellSize - 1, cellSize - 1);
-            n->setPos(c * cellSize, r * cellSize);
-            m_scene->addItem(n);
-            m_nodes[r][c] = n;
-        }
-    }
-
-    m_start = QPoint(0, 0);
-    m_target = QPoint(m_rows - 1, m_cols - 1);
-    // mark start/target visuals
-    m_nodes[m_start.x()][m_start.y()]->setAsStart();
-    m_nodes[m_target.x()][m_target.y()]->setAsTarget();
+    m_item = new GridItem(1, 1, DefaultCellSize);
+    m_scene->addItem(m_item);
+    // One static item: BSP indexing buys nothing
+    m_scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+    resize(rows, cols);
 
     // Install this object as an event filter on the scene so we can handle clicks
     m_scene->installEventFilter(this);
 }
 
 Grid::~Grid() {
-    // QGraphicsScene will delete items when destroyed; nothing to free here
+    // QGraphicsScene will delete the item when destroyed; nothing to free here
 }
 
 Grid::Model Grid::exportModel() const {
     Model m;
-    m.grid = QVector<QVector<int>>(m_rows, QVector<int>(m_cols, 0));
-    for (int r = 0; r < m_rows; ++r)
-        for (int c = 0; c < m_cols; ++c)
-            m.grid[r][c] = m_nodes[r][c]->isWall() ? 1 : 0;
+    m.grid = pathfinding::GridMap(m_rows, m_cols);
+    for (int r = 0; r < m_rows; ++r) {
+        const uchar *src = m_item->rowData(r);
+        for (int c0 = 0; c0 < m_cols; c0 += 64) {
+            const int n = qMin(64, m_cols - c0);
+            std::uint64_t bits = 0;
+            for (int i = 0; i < n; ++i)
+                if (src[c0 + i] == GridItem::Wall) bits |= std::uint64_t(1) << i;
+            if (bits) m.grid.setWalls(r * m_cols + c0, bits, n);
+        }
+    }
+    if (!m_costs.empty()) m.grid.setCosts(m_costs.data());
     m.start = m_start;
     m.target = m_target;
     return m;
 }
 
+void Grid::importModel(const Model &model) {
+    if (model.grid.rows() != m_rows || model.grid.cols() != m_cols)
+        resize(model.grid.rows(), model.grid.cols(), m_item->cellSize());
+    m_item->clearOverlay(); // belongs to the previous map
+    clearPathPolyline();
+
+    if (model.grid.hasCosts())
+        m_costs.assign(model.grid.costData(), model.grid.costData() + model.grid.size());
+    else
+        m_costs.clear();
+
+    for (int r = 0; r < m_rows; ++r) {
+        for (int c = 0; c < m_cols; ++c) {
+            m_item->setStateNoUpdate(r, c, model.grid.isWall(r, c)
+                                               ? GridItem::Wall
+                                               : GridItem::terrainState(costAt(r, c)));
+        }
+    }
+
+    if (model.grid.inBounds(model.start.x(), model.start.y())) m_start = model.start;
+    if (model.grid.inBounds(model.target.x(), model.target.y())) m_target = model.target;
+    m_item->setStateNoUpdate(m_start.x(), m_start.y(), GridItem::Start);
+    m_item->setStateNoUpdate(m_target.x(), m_target.y(), GridItem::Target);
+    m_item->update();
+}
+
+void Grid::resize(int rows, int cols, int cellSize) {
+    m_rows = qBound(MinDimension, rows, MaxDimension);
+    m_cols = qBound(MinDimension, cols, MaxDimension);
+    m_item->resize(m_rows, m_cols, qMax(1, cellSize));
+    m_scene->setSceneRect(m_item->boundingRect());
+    m_costs.clear();
+    clearPathPolyline();
+
+    m_start = QPoint(0, 0);
+    m_target = QPoint(m_rows - 1, m_cols - 1);
+    // mark start/target visuals
+    m_item->setState(m_start.x(), m_start.y(), GridItem::Start);
+    m_item->setState(m_target.x(), m_target.y(), GridItem::Target);
+}
+
+int Grid::costAt(int r, int c) const {
+    return m_costs.empty() ? 1 : m_costs[std::size_t(r) * m_cols + c];
+}
+
+void Grid::setCostAt(int r, int c, int cost) {
+    cost = qBound(1, cost, 255);
+    if (m_costs.empty()) {
+        if (cost == 1) return;
+        m_costs.assign(std::size_t(m_rows) * m_cols, 1);
+    }
+    m_costs[std::size_t(r) * m_cols + c] = std::uint8_t(cost);
+}
+
 void Grid::markVisited(int r, int c) {
     if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
-    m_nodes[r][c]->setVisited(true);
+    if (!GridItem::isOpen(m_item->state(r, c))) return;
+    m_item->setState(r, c, GridItem::Visited);
 }
 
 void Grid::markPath(int r, int c) {
     if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
-    m_nodes[r][c]->setPath(true);
+    const auto s = m_item->state(r, c);
+    if (s == GridItem::Wall || s == GridItem::Start || s == GridItem::Target) return;
+    m_item->setState(r, c, GridItem::Path);
+}
+
+/**
+ * Batch updates write the cell bytes directly and schedule one repaint
+ * covering the bounding box of the changed cells.
+ */
+void Grid::markVisitedCells(const QVector<int> &cells) {
+    markOpenCells(cells, GridItem::Visited);
+}
+
+void Grid::markBackwardVisitedCells(const QVector<int> &cells) {
+    markOpenCells(cells, GridItem::VisitedBackward);
+}
+
+void Grid::markOpenCells(const QVector<int> &cells, uchar state) {
+    QRect dirty;
+    for (int idx : cells) {
+        const int r = idx / m_cols, c = idx % m_cols;
+        if (r < 0 || r >= m_rows) continue;
+        if (!GridItem::isOpen(m_item->state(r, c))) continue;
+        m_item->setStateNoUpdate(r, c, GridItem::CellState(state));
+        dirty |= QRect(c, r, 1, 1);
+    }
+    m_item->updateCells(dirty);
+}
+
+void Grid::markPathCells(const QVector<int> &cells) {
+    QRect dirty;
+    for (int idx : cells) {
+        const int r = idx / m_cols, c = idx % m_cols;
+        if (r < 0 || r >= m_rows) continue;
+        const auto s = m_item->state(r, c);
+        if (s == GridItem::Wall || s == GridItem::Start || s == GridItem::Target) continue;
+        m_item->setStateNoUpdate(r, c, GridItem::Path);
+        dirty |= QRect(c, r, 1, 1);
+    }
+    m_item->updateCells(dirty);
+}
+
+void Grid::clearSearchMarks() {
+    for (int r = 0; r < m_rows; ++r) {
+        for (int c = 0; c < m_cols; ++c) {
+            const auto s = m_item->state(r, c);
+            if (s == GridItem::Visited || s == GridItem::VisitedBackward || s == GridItem::Path)
+                m_item->setStateNoUpdate(r, c, GridItem::terrainState(costAt(r, c)));
+        }
+    }
+    m_item->update();
+    clearPathPolyline();
+}
+
+void Grid::showPathPolyline(const QVector<int> &cells) {
+    if (cells.isEmpty()) return;
+    const qreal size = m_item->cellSize();
+    auto center = [&](int cell) {
+        return QPointF((cell % m_cols + 0.5) * size, (cell / m_cols + 0.5) * size);
+    };
+    QPainterPath path(center(cells.front()));
+    for (int i = 1; i < cells.size(); ++i)
+        path.lineTo(center(cells[i]));
+
+    if (!m_polyline) {
+        // Cosmetic, so the line keeps its width when a large grid is zoomed out
+        QPen pen(QColor(255, 140, 0), 3);
+        pen.setCosmetic(true);
+        pen.setJoinStyle(Qt::RoundJoin);
+        m_polyline = m_scene->addPath(QPainterPath(), pen);
+        m_polyline->setZValue(1); // above the GridItem
+        m_polyline->setAcceptedMouseButtons(Qt::NoButton);
+    }
+    m_polyline->setPath(path);
+    m_polyline->show();
+}
+
+void Grid::clearPathPolyline() {
+    if (m_polyline) m_polyline->hide();
 }
 
 void Grid::reset() {
-    for (int r = 0; r < m_rows; ++r)
-        for (int c = 0; c < m_cols; ++c)
-            m_nodes[r][c]->reset();
+    m_item->fill(GridItem::Empty);
+    m_item->clearOverlay();
+    clearPathPolyline();
+    m_costs.clear();
 
     // re-mark start/target
-    m_nodes[m_start.x()][m_start.y()]->setAsStart();
-    m_nodes[m_target.x()][m_target.y()]->setAsTarget();
+    m_item->setState(m_start.x(), m_start.y(), GridItem::Start);
+    m_item->setState(m_target.x(), m_target.y(), GridItem::Target);
+}
+
+/**
+ * Distances are scaled to palette entries 1..255 (near = blue, far = red),
+ * drawn half transparent over the cells; entry 0 stays clear.
+ */
+void Grid::showDistanceField(const QVector<int> &dist) {
+    if (dist.size() != m_rows * m_cols) return;
+    int maxDist = 1;
+    for (int d : dist) maxDist = qMax(maxDist, d);
+
+    QVector<QRgb> colors(256);
+    colors[0] = qRgba(0, 0, 0, 0);
+    for (int i = 1; i < 256; ++i)
+        colors[i] = QColor::fromHsv((255 - i) * 240 / 254, 220, 255, 150).rgba();
+
+    QImage overlay(m_cols, m_rows, QImage::Format_Indexed8);
+    overlay.setColorTable(colors);
+    for (int r = 0; r < m_rows; ++r) {
+        uchar *dst = overlay.scanLine(r);
+        const int *src = dist.constData() + std::size_t(r) * m_cols;
+        for (int c = 0; c < m_cols; ++c)
+            dst[c] = src[c] < 0 ? 0 : uchar(1 + qint64(src[c]) * 254 / maxDist);
+    }
+    m_item->setOverlay(overlay);
+}
+
+/**
+ * Region ids are hashed onto 255 half-transparent hues, so neighboring
+ * regions almost always differ; walls stay clear.
+ */
+void Grid::showComponents(const QVector<int> &labels) {
+    if (labels.size() != m_rows * m_cols) return;
+    QVector<QRgb> colors(256);
+    colors[0] = qRgba(0, 0, 0, 0);
+    for (int i = 1; i < 256; ++i)
+        colors[i] = QColor::fromHsv((i * 137) % 360, 170 + (i % 3) * 40, 255, 130).rgba();
+
+    QImage overlay(m_cols, m_rows, QImage::Format_Indexed8);
+    overlay.setColorTable(colors);
+    for (int r = 0; r < m_rows; ++r) {
+        uchar *dst = overlay.scanLine(r);
+        const int *src = labels.constData() + std::size_t(r) * m_cols;
+        for (int c = 0; c < m_cols; ++c)
+            dst[c] = src[c] < 0 ? 0 : uchar(1 + (quint32(src[c]) * 2654435761u >> 16) % 255);
+    }
+    m_item->setOverlay(overlay);
+}
+
+void Grid::clearHeatMap() {
+    m_item->clearOverlay();
+}
+
+void Grid::setHeatMapVisible(bool visible) {
+    m_item->setOverlayVisible(visible);
+}
+
+void Grid::setClusterBoundsVisible(bool visible) {
+    m_item->setClusterSize(visible ? pathfinding::HierarchicalGraph::DefaultClusterSize : 0);
+}
+
+void Grid::setVisitedColor(const QColor &color) {
+    m_item->setStateColor(GridItem::Visited, color.rgb());
 }
 
 /**
  * eventFilter intercepts scene mouse press events and delegates to handlers.
- * Left click: toggle wall
+ * Left click: toggle wall, or paint the current cost brush
  * Right click: set start
  * Middle click or Shift+Left: set target
  */
 bool Grid::eventFilter(QObject *watched, QEvent *event) {
-    if (watched == m_scene && event->type() == QEvent::GraphicsSceneMousePress) {
+    if (watched == m_scene && m_editable && event->type() == QEvent::GraphicsSceneMousePress) {
         auto *mouseEvent = static_cast<QGraphicsSceneMouseEvent*>(event);
         QPointF scenePos = mouseEvent->scenePos();
         if (mouseEvent->button() == Qt::LeftButton && !(mouseEvent->modifiers() & Qt::ShiftModifier)) {
-            toggleWallAtScenePos(scenePos);
+            paintAtScenePos(scenePos);
             return true;
         } else if (mouseEvent->button() == Qt::RightButton) {
             setStartAtScenePos(scenePos);
@@ -91,41 +288,46 @@ bool Grid::eventFilter(QObject *watched, QEvent *event) {
     return QObject::eventFilter(watched, event);
 }
 
-static QPointF roundToCellTopLeft(const QPointF &pos, int cellSize) {
-    int c = int(pos.x()) / cellSize;
-    int r = int(pos.y()) / cellSize;
-    return QPointF(c * cellSize, r * cellSize);
+bool Grid::cellAtScenePos(const QPointF &scenePos, int &r, int &c) const {
+    if (scenePos.x() < 0 || scenePos.y() < 0) return false;
+    c = int(scenePos.x()) / m_item->cellSize();
+    r = int(scenePos.y()) / m_item->cellSize();
+    return r >= 0 && r < m_rows && c >= 0 && c < m_cols;
 }
 
-void Grid::toggleWallAtScenePos(const QPointF &scenePos) {
-    const int cellSize = 22;
-    int c = int(scenePos.x()) / cellSize;
-    int r = int(scenePos.y()) / cellSize;
-    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
-    Node *n = m_nodes[r][c];
+void Grid::paintAtScenePos(const QPointF &scenePos) {
+    int r, c;
+    if (!cellAtScenePos(scenePos, r, c)) return;
     // don't allow changing start/target into walls
     if (QPoint(r, c) == m_start || QPoint(r, c) == m_target) return;
-    n->setWall(!n->isWall());
+    if (m_brush == WallBrush) {
+        const bool wall = m_item->state(r, c) == GridItem::Wall;
+        m_item->setState(r, c, wall ? GridItem::terrainState(costAt(r, c)) : GridItem::Wall);
+    } else {
+        setCostAt(r, c, m_brush);
+        m_item->setState(r, c, GridItem::terrainState(costAt(r, c)));
+    }
+    emit edited();
 }
 
 void Grid::setStartAtScenePos(const QPointF &scenePos) {
-    const int cellSize = 22;
-    int c = int(scenePos.x()) / cellSize;
-    int r = int(scenePos.y()) / cellSize;
-    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
+    int r, c;
+    if (!cellAtScenePos(scenePos, r, c)) return;
+    if (QPoint(r, c) == m_target) return;
     // clear old start
-    m_nodes[m_start.x()][m_start.y()]->reset();
+    m_item->setState(m_start.x(), m_start.y(), GridItem::terrainState(costAt(m_start.x(), m_start.y())));
     m_start = QPoint(r, c);
-    m_nodes[m_start.x()][m_start.y()]->setAsStart();
+    m_item->setState(m_start.x(), m_start.y(), GridItem::Start);
+    emit edited();
 }
 
 void Grid::setTargetAtScenePos(const QPointF &scenePos) {
-    const int cellSize = 22;
-    int c = int(scenePos.x()) / cellSize;
-    int r = int(scenePos.y()) / cellSize;
-    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
+    int r, c;
+    if (!cellAtScenePos(scenePos, r, c)) return;
+    if (QPoint(r, c) == m_start) return;
     // clear old target
-    m_nodes[m_target.x()][m_target.y()]->reset();
+    m_item->setState(m_target.x(), m_target.y(), GridItem::terrainState(costAt(m_target.x(), m_target.y())));
     m_target = QPoint(r, c);
-    m_nodes[m_target.x()][m_target.y()]->setAsTarget();
+    m_item->setState(m_target.x(), m_target.y(), GridItem::Target);
+    emit edited();
 }
@@ -0,0 +1,169 @@
+#include "GridItem.hpp"
+
+#include <QPainter>
+#include <QPen>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+
+GridItem::GridItem(int rows, int cols, int cellSize)
+    : QGraphicsItem(),
+      m_rows(rows),
+      m_cols(cols),
+      m_cellSize(cellSize),
+      m_cells(cols, rows, QImage::Format_Indexed8)
+{
+    QVector<QRgb> colors(256, qRgb(255, 0, 255));
+    colors[Empty] = qRgb(255, 255, 255);
+    colors[Wall] = qRgb(0, 0, 0);
+    colors[Visited] = qRgb(135, 206, 250); // light sky blue
+    colors[Path] = qRgb(255, 215, 0);      // gold
+    colors[Start] = qRgb(0, 180, 0);       // green
+    colors[Target] = qRgb(200, 0, 0);      // red
+    colors[VisitedBackward] = qRgb(255, 182, 193); // light pink
+    // Terrain: light tan (cheap) to dark brown (expensive)
+    for (int v = TerrainBase; v < 256; ++v) {
+        const qreal t = qreal(v - TerrainBase) / (255 - TerrainBase);
+        colors[v] = qRgb(int(235 - t * 140), int(215 - t * 150), int(170 - t * 140));
+    }
+    m_cells.setColorTable(colors);
+    m_cells.fill(Empty);
+
+    // exposedRect is only filled in with this flag
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+    setAcceptHoverEvents(false);
+}
+
+void GridItem::resize(int rows, int cols, int cellSize) {
+    prepareGeometryChange();
+    const QVector<QRgb> colors = m_cells.colorTable();
+    m_rows = rows;
+    m_cols = cols;
+    m_cellSize = cellSize;
+    m_cells = QImage(cols, rows, QImage::Format_Indexed8);
+    m_cells.setColorTable(colors);
+    m_cells.fill(Empty);
+    m_overlay = QImage();
+    update();
+}
+
+void GridItem::setStateColor(CellState s, QRgb color) {
+    m_cells.setColor(s, color);
+    update();
+}
+
+void GridItem::setOverlay(const QImage &overlay) {
+    m_overlay = overlay.size() == m_cells.size() ? overlay : QImage();
+    update();
+}
+
+void GridItem::clearOverlay() {
+    if (m_overlay.isNull()) return;
+    m_overlay = QImage();
+    update();
+}
+
+void GridItem::setOverlayVisible(bool visible) {
+    if (m_overlayVisible == visible) return;
+    m_overlayVisible = visible;
+    update();
+}
+
+void GridItem::setClusterSize(int clusterSize) {
+    clusterSize = qMax(0, clusterSize);
+    if (m_clusterSize == clusterSize) return;
+    m_clusterSize = clusterSize;
+    update();
+}
+
+GridItem::CellState GridItem::terrainState(int cost) {
+    if (cost <= 1) return Empty;
+    // Costs 2..255 spread over the terrain shades
+    return CellState(TerrainBase + (qMin(cost, 255) - 2) * (255 - TerrainBase) / 253);
+}
+
+QRectF GridItem::boundingRect() const {
+    return QRectF(0, 0, qreal(m_cols) * m_cellSize, qreal(m_rows) * m_cellSize);
+}
+
+void GridItem::setState(int r, int c, CellState s) {
+    setStateNoUpdate(r, c, s);
+    updateCells(QRect(c, r, 1, 1));
+}
+
+void GridItem::fill(CellState s) {
+    m_cells.fill(s);
+    update();
+}
+
+void GridItem::updateCells(const QRect &cells) {
+    if (cells.isEmpty()) return;
+    update(QRectF(qreal(cells.x()) * m_cellSize, qreal(cells.y()) * m_cellSize,
+                  qreal(cells.width()) * m_cellSize, qreal(cells.height()) * m_cellSize));
+}
+
+/**
+ * Draws only the exposed cell range. When zoomed out so far that several
+ * cells share a screen pixel, every step-th cell is sampled first so the
+ * work stays proportional to the viewport, not to the grid size.
+ */
+void GridItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(widget);
+    const QRectF exposed = option->exposedRect.intersected(boundingRect());
+    if (exposed.isEmpty()) return;
+
+    const int c0 = qMax(0, int(exposed.left() / m_cellSize));
+    const int r0 = qMax(0, int(exposed.top() / m_cellSize));
+    const int c1 = qMin(m_cols, int(qCeil(exposed.right() / m_cellSize)));
+    const int r1 = qMin(m_rows, int(qCeil(exposed.bottom() / m_cellSize)));
+    if (c1 <= c0 || r1 <= r0) return;
+
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    const qreal pixelsPerCell = lod * m_cellSize;
+    const int step = pixelsPerCell >= 1.0 ? 1 : int(1.0 / pixelsPerCell);
+
+    const QRectF target(qreal(c0) * m_cellSize, qreal(r0) * m_cellSize,
+                        qreal(c1 - c0) * m_cellSize, qreal(r1 - r0) * m_cellSize);
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->drawImage(target, sampleRegion(m_cells, c0, r0, c1, r1, step));
+    if (m_overlayVisible && !m_overlay.isNull())
+        painter->drawImage(target, sampleRegion(m_overlay, c0, r0, c1, r1, step));
+
+    // Cell borders only once cells are big enough on screen to tell apart
+    if (pixelsPerCell >= 6.0) {
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->setPen(QPen(Qt::lightGray, 0));
+        for (int c = c0; c <= c1; ++c)
+            painter->drawLine(QLineF(qreal(c) * m_cellSize, target.top(), qreal(c) * m_cellSize, target.bottom()));
+        for (int r = r0; r <= r1; ++r)
+            painter->drawLine(QLineF(target.left(), qreal(r) * m_cellSize, target.right(), qreal(r) * m_cellSize));
+    }
+
+    // Cluster boundaries stay visible at any zoom: 2 pixels wide whatever the scale
+    if (m_clusterSize > 0) {
+        QPen pen(QColor(70, 90, 200, 180), 2);
+        pen.setCosmetic(true);
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->setPen(pen);
+        for (int c = (c0 + m_clusterSize - 1) / m_clusterSize * m_clusterSize; c <= c1; c += m_clusterSize)
+            painter->drawLine(QLineF(qreal(c) * m_cellSize, target.top(), qreal(c) * m_cellSize, target.bottom()));
+        for (int r = (r0 + m_clusterSize - 1) / m_clusterSize * m_clusterSize; r <= r1; r += m_clusterSize)
+            painter->drawLine(QLineF(target.left(), qreal(r) * m_cellSize, target.right(), qreal(r) * m_cellSize));
+    }
+}
+
+QImage GridItem::sampleRegion(const QImage &image, int c0, int r0, int c1, int r1, int step) {
+    if (step == 1) return image.copy(c0, r0, c1 - c0, r1 - r0);
+
+    const int w = (c1 - c0 + step - 1) / step;
+    const int h = (r1 - r0 + step - 1) / step;
+    QImage region(w, h, QImage::Format_Indexed8);
+    region.setColorTable(image.colorTable());
+    for (int y = 0; y < h; ++y) {
+        const uchar *src = image.constScanLine(r0 + y * step) + c0;
+        uchar *dst = region.scanLine(y);
+        for (int x = 0; x < w; ++x)
+            dst[x] = src[x * step];
+    }
+    return region;
+}
@@ -0,0 +1,62 @@
+#include "GridView.hpp"
+
+#include <QMouseEvent>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <QtMath>
+
+GridView::GridView(QGraphicsScene *scene, QWidget *parent)
+    : QGraphicsView(scene, parent), m_panning(false)
+{
+    // Cells are drawn pixel-exact by GridItem; no antialiasing needed
+    setRenderHint(QPainter::Antialiasing, false);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    setOptimizationFlag(QGraphicsView::DontSavePainterState, true);
+}
+
+void GridView::wheelEvent(QWheelEvent *event) {
+    const qreal factor = qPow(1.0015, event->angleDelta().y());
+    const qreal current = transform().m11();
+    // Clamp between a whole-map overview of very large grids and a handful of cells on screen
+    if ((factor > 1.0 && current * factor > 64.0) || (factor < 1.0 && current * factor < 1e-4)) {
+        event->accept();
+        return;
+    }
+    scale(factor, factor);
+    event->accept();
+}
+
+void GridView::mousePressEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton && (event->modifiers() & Qt::ControlModifier)) {
+        m_panning = true;
+        m_lastPanPos = event->position().toPoint();
+        setCursor(Qt::ClosedHandCursor);
+        event->accept();
+        return;
+    }
+    QGraphicsView::mousePressEvent(event);
+}
+
+void GridView::mouseMoveEvent(QMouseEvent *event) {
+    if (m_panning) {
+        const QPoint pos = event->position().toPoint();
+        const QPoint delta = pos - m_lastPanPos;
+        m_lastPanPos = pos;
+        horizontalScrollBar()->setValue(horizontalScrollBar()->value() - delta.x());
+        verticalScrollBar()->setValue(verticalScrollBar()->value() - delta.y());
+        event->accept();
+        return;
+    }
+    QGraphicsView::mouseMoveEvent(event);
+}
+
+void GridView::mouseReleaseEvent(QMouseEvent *event) {
+    if (m_panning && event->button() == Qt::LeftButton) {
+        m_panning = false;
+        unsetCursor();
+        event->accept();
+        return;
+    }
+    QGraphicsView::mouseReleaseEvent(event);
+}
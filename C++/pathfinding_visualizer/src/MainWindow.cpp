@@ -1,43 +1,104 @@
 #include "MainWindow.hpp"
 #include "Grid.hpp"
+#include "GridView.hpp"
+#include "RaceWindow.hpp"
+#include "RunReportPanel.hpp"
+#include "TracePlayer.hpp"
 #include "Algorithms/AlgorithmWorker.hpp"
+#include "Core/MapIO.hpp"
+#include "Core/SearchTrace.hpp"
 
-#include <QGraphicsView>
 #include <QToolBar>
 #include <QAction>
 #include <QIcon>
 #include <QComboBox>
 #include <QSlider>
 #include <QLabel>
+#include <QDockWidget>
 #include <QStatusBar>
 #include <QKeyEvent>
 #include <QMetaObject>
+#include <QSignalBlocker>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QInputDialog>
+#include <QSpinBox>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDir>
+#include <QMessageBox>
 
-MainWindow::MainWindow(QWidget *parent)
+MainWindow::MainWindow(int rows, int cols, QWidget *parent)
     : QMainWindow(parent),
       m_grid(nullptr),
+      m_view(nullptr),
       m_worker(nullptr),
       m_workerThread(nullptr),
+      m_reportPanel(nullptr),
+      m_reportDock(nullptr),
+      m_raceWindow(nullptr),
       m_runAction(nullptr),
       m_resetAction(nullptr),
+      m_turboAction(nullptr),
+      m_resizeAction(nullptr),
+      m_openAction(nullptr),
+      m_saveAction(nullptr),
+      m_openTraceAction(nullptr),
+      m_saveTraceAction(nullptr),
+      m_batchAction(nullptr),
+      m_raceAction(nullptr),
+      m_fitAction(nullptr),
+      m_heatMapAction(nullptr),
+      m_clustersAction(nullptr),
+      m_componentsAction(nullptr),
+      m_pauseAction(nullptr),
+      m_stepAction(nullptr),
       m_algoSelector(nullptr),
+      m_brushSelector(nullptr),
+      m_queueSelector(nullptr),
+      m_movesSelector(nullptr),
       m_speedSlider(nullptr),
+      m_traceSlider(nullptr),
       m_statusLabel(nullptr),
       m_currentAlgo("A*"),
       m_speedMs(40),
-      m_isRunning(false)
+      m_isRunning(false),
+      m_turbo(false),
+      m_planActive(false),
+      m_replanPending(false),
+      m_drawAtOnce(false),
+      m_batchRunning(false)
 {
     setWindowTitle("Pathfinding Visualizer - Code_Script");
     resize(1280, 720);
 
-    m_grid = new Grid(30, 50, this);
-    QGraphicsView *view = new QGraphicsView(m_grid->scene(), this);
-    view->setRenderHint(QPainter::Antialiasing);
-    setCentralWidget(view);
+    m_grid = new Grid(rows, cols, this);
+    m_view = new GridView(m_grid->scene(), this);
+    setCentralWidget(m_view);
+
+    m_player = new TracePlayer(m_grid, this);
+    m_player->setDelayMs(m_speedMs);
+
+    m_reportPanel = new RunReportPanel(this);
+    m_reportDock = new QDockWidget("Run report", this);
+    m_reportDock->setObjectName("runReport");
+    m_reportDock->setWidget(m_reportPanel);
+    addDockWidget(Qt::RightDockWidgetArea, m_reportDock);
 
     createToolbar();
     m_statusLabel = new QLabel("Ready", this);
     statusBar()->addWidget(m_statusLabel);
+    m_traceSlider = new QSlider(Qt::Horizontal, this);
+    m_traceSlider->setFixedWidth(240);
+    m_traceSlider->setEnabled(false);
+    m_traceSlider->setToolTip("Scrub through the replay of the last search (, and . step one event)");
+    statusBar()->addPermanentWidget(m_traceSlider);
+    connect(m_traceSlider, &QSlider::valueChanged, m_player, [this](int value) { m_player->seek(value); });
+    connect(m_player, &TracePlayer::positionChanged, this, &MainWindow::onTracePosition);
 
     // Worker and thread
     m_worker = new AlgorithmWorker();
@@ -46,14 +107,25 @@ MainWindow::MainWindow(QWidget *parent)
     m_workerThread->start();
 
     // Connect worker signals -> main window slots
-    connect(m_worker, &AlgorithmWorker::visit, this, &MainWindow::handleVisit);
-    connect(m_worker, &AlgorithmWorker::pathNode, this, &MainWindow::handlePathNode);
+    connect(m_worker, &AlgorithmWorker::traceRecorded, this, &MainWindow::handleTrace);
+    connect(m_worker, &AlgorithmWorker::pathBatch, this, &MainWindow::handlePathBatch);
+    connect(m_worker, &AlgorithmWorker::searchStats, this, &MainWindow::handleSearchStats);
+    connect(m_worker, &AlgorithmWorker::scratchMemory, this, &MainWindow::handleScratchMemory);
+    connect(m_worker, &AlgorithmWorker::distanceField, this, &MainWindow::handleDistanceField);
+    connect(m_worker, &AlgorithmWorker::componentLabels, this, &MainWindow::handleComponentLabels);
     connect(m_worker, &AlgorithmWorker::status, this, &MainWindow::handleStatus);
     connect(m_worker, &AlgorithmWorker::finished, this, &MainWindow::handleWorkerFinished);
+    connect(m_grid, &Grid::edited, this, &MainWindow::onGridEdited);
+
+    // The dock starts shown, so the worker counts from the first run
+    onReportToggled(true);
+
+    // The viewport only has its final size once the window is shown
+    QTimer::singleShot(0, this, [this]() { applyGridSize(m_grid->rows(), m_grid->cols()); });
 
     // Ensure thread quits when window destroyed
     connect(this, &QObject::destroyed, [this]() {
-        if (m_worker) m_worker->requestAbort();
+        if (m_worker) m_worker->cancelRuns(m_nextRunId);
         if (m_workerThread && m_workerThread->isRunning()) {
             m_workerThread->quit();
             m_workerThread->wait();
@@ -63,7 +135,8 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow() {
     if (m_worker) {
-        m_worker->requestAbort();
+        // Stops the search in progress within one expansion, so the thread can quit
+        m_worker->cancelRuns(m_nextRunId);
     }
     if (m_workerThread && m_workerThread->isRunning()) {
         m_workerThread->quit();
@@ -78,106 +151,626 @@ void MainWindow::createToolbar() {
 
     m_runAction = toolbar->addAction("Run");
     m_resetAction = toolbar->addAction("Reset");
+    m_turboAction = toolbar->addAction("Turbo");
+    m_turboAction->setCheckable(true);
+    m_turboAction->setToolTip("Skip the replay: draw each search's result at once");
+    m_pauseAction = toolbar->addAction("Pause");
+    m_pauseAction->setCheckable(true);
+    m_pauseAction->setToolTip("Hold the replay where it is (Shift+Space)");
+    m_stepAction = toolbar->addAction("Step");
+    m_stepAction->setToolTip("Advance the replay by one event, running the search first if there is none (.)");
+    m_openAction = toolbar->addAction("Open...");
+    m_saveAction = toolbar->addAction("Save...");
+    m_openTraceAction = toolbar->addAction("Open Trace...");
+    m_openTraceAction->setToolTip("Replay a saved search trace recorded on a grid of this size");
+    m_saveTraceAction = toolbar->addAction("Save Trace...");
+    m_saveTraceAction->setToolTip("Save the last search's expansions and path for offline comparison");
+    m_resizeAction = toolbar->addAction("Resize...");
+    m_batchAction = toolbar->addAction("Batch...");
+    m_batchAction->setToolTip("Solve many random start/target pairs in parallel with the selected algorithm");
+    m_raceAction = toolbar->addAction("Race...");
+    m_raceAction->setToolTip("Run several algorithms at once on a snapshot of this map, each on its own thread");
+    m_fitAction = toolbar->addAction("Fit");
+    m_heatMapAction = toolbar->addAction("Heat map");
+    m_heatMapAction->setCheckable(true);
+    m_heatMapAction->setChecked(true);
+    m_heatMapAction->setToolTip("Show the cost-to-target field of the last flow-field run");
+    m_clustersAction = toolbar->addAction("Clusters");
+    m_clustersAction->setCheckable(true);
+    m_clustersAction->setToolTip("Show the HPA* cluster boundaries");
+    m_componentsAction = toolbar->addAction("Regions");
+    m_componentsAction->setCheckable(true);
+    m_componentsAction->setToolTip("Color each connected region; searches between regions stop at once");
+    QAction *reportAction = m_reportDock->toggleViewAction();
+    reportAction->setText("Report");
+    reportAction->setToolTip("Show the last search's counters: open-list traffic, time split and allocations");
+    toolbar->addAction(reportAction);
 
     m_algoSelector = new QComboBox(this);
-    m_algoSelector->addItems({"BFS", "Dijkstra", "A*"});
+    // Item data is the pathfinding::Algorithm passed to the worker
+    for (auto algo : {pathfinding::Algorithm::BFS, pathfinding::Algorithm::Dijkstra, pathfinding::Algorithm::AStar,
+                      pathfinding::Algorithm::JPS, pathfinding::Algorithm::BlockJPS,
+                      pathfinding::Algorithm::BidirectionalBFS, pathfinding::Algorithm::BidirectionalAStar,
+                      pathfinding::Algorithm::ParallelBFS, pathfinding::Algorithm::FlowField,
+                      pathfinding::Algorithm::DStarLite, pathfinding::Algorithm::HPA,
+                      pathfinding::Algorithm::ThetaStar, pathfinding::Algorithm::LazyThetaStar})
+        m_algoSelector->addItem(pathfinding::algorithmName(algo), static_cast<int>(algo));
+    m_algoSelector->setCurrentText(m_currentAlgo);
     toolbar->addWidget(m_algoSelector);
 
+    // Left-click brush: walls or terrain with a traversal cost
+    m_brushSelector = new QComboBox(this);
+    m_brushSelector->addItem("Wall", Grid::WallBrush);
+    m_brushSelector->addItem("Road (1)", 1);
+    m_brushSelector->addItem("Grass (3)", 3);
+    m_brushSelector->addItem("Mud (8)", 8);
+    m_brushSelector->addItem("Water (25)", 25);
+    m_brushSelector->addItem("Rock (100)", 100);
+    m_brushSelector->setToolTip("What left click paints; Dijkstra and A* use the cell costs");
+    toolbar->addWidget(m_brushSelector);
+
+    // Open list used by Dijkstra and A*
+    m_queueSelector = new QComboBox(this);
+    for (auto kind : {pathfinding::QueueKind::BinaryHeap, pathfinding::QueueKind::QuaternaryHeap,
+                      pathfinding::QueueKind::BucketQueue, pathfinding::QueueKind::RadixHeap})
+        m_queueSelector->addItem(pathfinding::queueKindName(kind), int(kind));
+    m_queueSelector->setToolTip("Open list (priority queue) for Dijkstra and A*");
+    toolbar->addWidget(m_queueSelector);
+
+    // Movement model of BFS, Dijkstra and A*: -1 = 4-way, otherwise the 8-way CornerCutting rule
+    m_movesSelector = new QComboBox(this);
+    m_movesSelector->addItem("4-way", -1);
+    m_movesSelector->addItem("8-way, no corner cutting", int(pathfinding::CornerCutting::Never));
+    m_movesSelector->addItem("8-way, cut corners", int(pathfinding::CornerCutting::OneSide));
+    m_movesSelector->addItem("8-way, squeeze through", int(pathfinding::CornerCutting::Always));
+    m_movesSelector->setToolTip("Movement for BFS, Dijkstra and A*; the other algorithms are 4-connected");
+    toolbar->addWidget(m_movesSelector);
+
     m_speedSlider = new QSlider(Qt::Horizontal, this);
-    m_speedSlider->setRange(5, 300);
+    m_speedSlider->setRange(0, 300);
     m_speedSlider->setValue(m_speedMs);
     m_speedSlider->setFixedWidth(200);
     toolbar->addWidget(m_speedSlider);
 
     connect(m_runAction, &QAction::triggered, this, &MainWindow::onRun);
     connect(m_resetAction, &QAction::triggered, this, &MainWindow::onReset);
+    connect(m_turboAction, &QAction::toggled, this, &MainWindow::onTurboToggled);
+    connect(m_pauseAction, &QAction::toggled, this, &MainWindow::onPauseToggled);
+    connect(m_stepAction, &QAction::triggered, this, &MainWindow::onStep);
+    connect(m_openAction, &QAction::triggered, this, &MainWindow::onOpenMap);
+    connect(m_saveAction, &QAction::triggered, this, &MainWindow::onSaveMap);
+    connect(m_openTraceAction, &QAction::triggered, this, &MainWindow::onOpenTrace);
+    connect(m_saveTraceAction, &QAction::triggered, this, &MainWindow::onSaveTrace);
+    connect(m_batchAction, &QAction::triggered, this, &MainWindow::onBatch);
+    connect(m_raceAction, &QAction::triggered, this, &MainWindow::onRace);
+    connect(m_resizeAction, &QAction::triggered, this, &MainWindow::onResizeGrid);
+    connect(m_fitAction, &QAction::triggered, this, &MainWindow::fitGridToView);
+    connect(m_heatMapAction, &QAction::toggled, m_grid, &Grid::setHeatMapVisible);
+    connect(m_clustersAction, &QAction::toggled, m_grid, &Grid::setClusterBoundsVisible);
+    connect(m_componentsAction, &QAction::toggled, this, &MainWindow::onComponentsToggled);
+    connect(reportAction, &QAction::toggled, this, &MainWindow::onReportToggled);
     connect(m_speedSlider, &QSlider::valueChanged, this, &MainWindow::onSpeedChanged);
     connect(m_algoSelector, &QComboBox::currentTextChanged, this, &MainWindow::onAlgoChanged);
+    connect(m_brushSelector, &QComboBox::currentIndexChanged, this, &MainWindow::onBrushChanged);
+    connect(m_queueSelector, &QComboBox::currentIndexChanged, this, &MainWindow::onQueueChanged);
+    connect(m_movesSelector, &QComboBox::currentIndexChanged, this, &MainWindow::onMovesChanged);
 }
 
 void MainWindow::onRun() {
     if (m_isRunning) {
-        // Request abort if already running
-        m_worker->requestAbort();
+        // Cancel the current run; the worker stops within one cell and reports it
+        m_worker->cancelRuns(m_runId);
         m_statusLabel->setText("Abort requested...");
         return;
     }
     m_statusLabel->setText("Preparing...");
+    m_lastRunSummary.clear();
     startAlgorithmOnWorker();
 }
 
 void MainWindow::startAlgorithmOnWorker() {
-    auto model = m_grid->exportModel(); // model.grid is QVector<QVector<int>>, start/target are QPoint
-    // Call the appropriate worker slot via queued connection
-    if (m_currentAlgo == "BFS") {
-        QMetaObject::invokeMethod(m_worker, "runBFS", Qt::QueuedConnection,
-                                  Q_ARG(QVector<QVector<int>>, model.grid),
-                                  Q_ARG(QPoint, model.start),
-                                  Q_ARG(QPoint, model.target),
-                                  Q_ARG(int, m_speedMs));
-    } else if (m_currentAlgo == "Dijkstra") {
-        QMetaObject::invokeMethod(m_worker, "runDijkstra", Qt::QueuedConnection,
-                                  Q_ARG(QVector<QVector<int>>, model.grid),
-                                  Q_ARG(QPoint, model.start),
-                                  Q_ARG(QPoint, model.target),
-                                  Q_ARG(int, m_speedMs));
-    } else {
-        QMetaObject::invokeMethod(m_worker, "runAStar", Qt::QueuedConnection,
-                                  Q_ARG(QVector<QVector<int>>, model.grid),
-                                  Q_ARG(QPoint, model.start),
-                                  Q_ARG(QPoint, model.target),
-                                  Q_ARG(int, m_speedMs));
+    m_player->clear();
+    m_reportPanel->clear();
+    m_runOptions = m_searchOptions;
+    auto model = m_grid->exportModel(); // model.grid is a flat pathfinding::GridMap, start/target are QPoint
+    const int algo = m_algoSelector->currentData().toInt();
+    m_runId = ++m_nextRunId;
+    QMetaObject::invokeMethod(m_worker, "runSearch", Qt::QueuedConnection,
+                              Q_ARG(quint64, m_runId),
+                              Q_ARG(int, algo),
+                              Q_ARG(pathfinding::GridMap, model.grid),
+                              Q_ARG(QPoint, model.start),
+                              Q_ARG(QPoint, model.target));
+    m_isRunning = true;
+    m_drawAtOnce = false;
+    m_planActive = algo == int(pathfinding::Algorithm::DStarLite);
+    const bool fourOnly = m_searchOptions.connectivity == pathfinding::Connectivity::Eight
+        && !pathfinding::supportsEightConnectivity(pathfinding::Algorithm(algo))
+        && !pathfinding::isAnyAngle(pathfinding::Algorithm(algo));
+    m_statusLabel->setText((m_pauseAction->isChecked() ? "Paused - " : "Running ") + m_currentAlgo
+                           + (fourOnly ? " (4-connected only)" : ""));
+}
+
+/**
+ * While a D* Lite plan is shown, every edit is sent to the worker's planner,
+ * which repairs the plan and redraws it. Edits made during a replan are
+ * folded into one follow-up replan.
+ */
+void MainWindow::onGridEdited() {
+    if (m_componentsAction->isChecked()) requestComponents();
+    if (!m_planActive) return;
+    if (m_isRunning) {
+        m_replanPending = true;
+        return;
     }
+    startReplan();
+}
+
+void MainWindow::startReplan() {
+    m_replanPending = false;
+    m_grid->clearSearchMarks();
+    auto model = m_grid->exportModel();
+    m_runId = ++m_nextRunId;
+    m_runOptions = m_searchOptions;
+    m_drawAtOnce = true; // an edit should show its effect at once, whatever the replay speed
+    QMetaObject::invokeMethod(m_worker, "replan", Qt::QueuedConnection,
+                              Q_ARG(quint64, m_runId),
+                              Q_ARG(pathfinding::GridMap, model.grid),
+                              Q_ARG(QPoint, model.start),
+                              Q_ARG(QPoint, model.target));
+    m_isRunning = true;
+}
+
+/**
+ * The worker repairs its region labels for the edit and sends them back;
+ * the request queues behind a running search.
+ */
+void MainWindow::requestComponents() {
+    m_componentsRunId = ++m_nextRunId;
+    QMetaObject::invokeMethod(m_worker, "showComponents", Qt::QueuedConnection,
+                              Q_ARG(quint64, m_componentsRunId),
+                              Q_ARG(pathfinding::GridMap, m_grid->exportModel().grid));
+}
+
+void MainWindow::onComponentsToggled(bool on) {
+    if (on) requestComponents();
+    else m_grid->clearHeatMap();
+}
+
+/**
+ * Pause and step act on the replay only; the search itself has already run
+ * at full speed. A trace that arrives while paused waits at its first event.
+ */
+void MainWindow::onPauseToggled(bool on) {
+    m_player->setPaused(on);
+}
+
+void MainWindow::onStep() {
+    if (!m_pauseAction->isChecked()) m_pauseAction->setChecked(true);
+    if (m_player->trace())
+        m_player->stepForward();
+    else if (!m_isRunning)
+        onRun();
+}
+
+void MainWindow::onTracePosition(qint64 position, qint64 length) {
+    const QSignalBlocker blocker(m_traceSlider);
+    m_traceSlider->setEnabled(length > 0);
+    m_traceSlider->setRange(0, int(length));
+    m_traceSlider->setValue(int(position));
+}
+
+/**
+ * Counting costs a few instructions per push and pop, so the searches only
+ * count while someone can see the result.
+ */
+void MainWindow::onReportToggled(bool visible) {
+    m_searchOptions.counters = visible;
+    pushSearchOptions();
+}
+
+void MainWindow::cancelAllRuns() {
+    m_worker->cancelRuns(m_nextRunId);
+    m_runId = 0;
+    m_componentsRunId = 0;
+    m_isRunning = false;
+    m_batchRunning = false;
+    m_player->clear();
+    m_reportPanel->clear();
+}
+
+void MainWindow::onBatch() {
+    if (m_isRunning) return;
+    bool ok = false;
+    const int count = QInputDialog::getInt(this, "Batch Queries", "Random start/target pairs:", 1000, 1, 1000000, 100, &ok);
+    if (!ok) return;
+
+    m_player->clear();
+    m_reportPanel->clear();
+    m_grid->clearSearchMarks();
+    m_lastRunSummary.clear();
+    const int algo = m_algoSelector->currentData().toInt();
+    m_runId = ++m_nextRunId;
+    QMetaObject::invokeMethod(m_worker, "runBatch", Qt::QueuedConnection,
+                              Q_ARG(quint64, m_runId),
+                              Q_ARG(int, algo),
+                              Q_ARG(pathfinding::GridMap, m_grid->exportModel().grid),
+                              Q_ARG(int, count));
     m_isRunning = true;
-    m_statusLabel->setText("Running " + m_currentAlgo);
+    m_batchRunning = true;
+    m_planActive = false;
+    m_statusLabel->setText(QString("Solving %1 queries with %2...").arg(count).arg(m_currentAlgo));
+}
+
+/**
+ * Hands the race window a snapshot of the map as it is now; later edits
+ * here do not reach it until Race... is pressed again.
+ */
+void MainWindow::onRace() {
+    if (!m_raceWindow) m_raceWindow = new RaceWindow(this);
+    m_raceWindow->setSnapshot(m_grid->exportModel(), m_searchOptions);
+    m_raceWindow->show();
+    m_raceWindow->raise();
+    m_raceWindow->activateWindow();
+    m_statusLabel->setText("Race snapshot taken: pick the algorithms and press Start");
 }
 
 void MainWindow::onReset() {
-    m_worker->requestAbort();
+    // The old run's trace may still be queued for this thread; its stale id drops it
+    cancelAllRuns();
     m_grid->reset();
+    if (m_componentsAction->isChecked()) requestComponents();
     m_statusLabel->setText("Grid reset");
-    m_isRunning = false;
+    m_planActive = false;
+    m_replanPending = false;
 }
 
 void MainWindow::onSpeedChanged(int value) {
     m_speedMs = value;
+    // Only the replay slows down; a running or finished search is not repeated
+    m_player->setDelayMs(m_speedMs);
     m_statusLabel->setText(QString("Speed: %1 ms").arg(m_speedMs));
 }
 
 void MainWindow::onAlgoChanged(const QString &name) {
     m_currentAlgo = name;
+    m_planActive = false;
     m_statusLabel->setText("Algorithm: " + name);
 }
 
-void MainWindow::handleVisit(int row, int col) {
-    m_grid->markVisited(row, col);
+void MainWindow::onTurboToggled(bool on) {
+    m_turbo = on;
+    m_speedSlider->setEnabled(!on);
+    if (on) m_player->finish();
+    m_statusLabel->setText(on ? "Turbo mode on" : "Turbo mode off");
+}
+
+void MainWindow::onBrushChanged(int index) {
+    m_grid->setBrush(m_brushSelector->itemData(index).toInt());
+    m_statusLabel->setText("Brush: " + m_brushSelector->itemText(index));
+}
+
+void MainWindow::onQueueChanged(int index) {
+    m_searchOptions.queue = pathfinding::QueueKind(m_queueSelector->itemData(index).toInt());
+    pushSearchOptions();
+    m_statusLabel->setText(QString("Open list: %1").arg(m_queueSelector->itemText(index)));
+}
+
+void MainWindow::onMovesChanged(int index) {
+    const int rule = m_movesSelector->itemData(index).toInt();
+    m_searchOptions.connectivity = rule < 0 ? pathfinding::Connectivity::Four : pathfinding::Connectivity::Eight;
+    if (rule >= 0) m_searchOptions.corners = pathfinding::CornerCutting(rule);
+    pushSearchOptions();
+    m_statusLabel->setText(QString("Movement: %1").arg(m_movesSelector->itemText(index)));
+    // Squeezing between walls joins regions that only touch at a corner
+    if (m_componentsAction->isChecked()) requestComponents();
+}
+
+void MainWindow::pushSearchOptions() {
+    // Queued so it is applied in order with the run requests on the worker thread
+    QMetaObject::invokeMethod(m_worker, "setSearchOptions", Qt::QueuedConnection,
+                              Q_ARG(pathfinding::SearchOptions, m_searchOptions));
+}
+
+void MainWindow::onResizeGrid() {
+    QDialog dialog(this);
+    dialog.setWindowTitle("Grid Size");
+    auto *rowsSpin = new QSpinBox(&dialog);
+    auto *colsSpin = new QSpinBox(&dialog);
+    rowsSpin->setRange(Grid::MinDimension, Grid::MaxDimension);
+    colsSpin->setRange(Grid::MinDimension, Grid::MaxDimension);
+    rowsSpin->setValue(m_grid->rows());
+    colsSpin->setValue(m_grid->cols());
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    auto *form = new QFormLayout(&dialog);
+    form->addRow("Rows", rowsSpin);
+    form->addRow("Columns", colsSpin);
+    form->addRow(buttons);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    cancelAllRuns();
+    applyGridSize(rowsSpin->value(), colsSpin->value());
+    m_statusLabel->setText(QString("Grid %1 x %2").arg(m_grid->rows()).arg(m_grid->cols()));
+}
+
+/**
+ * Loads a .map / .pfgm file, or a MovingAI .scen file whose first entry
+ * supplies the map (resolved next to the .scen file) and the start/target.
+ * Maps without a scenario get start/target on the first and last free cells.
+ */
+void MainWindow::onOpenMap() {
+    const QString path = QFileDialog::getOpenFileName(this, "Open Map", QString(),
+        "Maps (*.map *.pfgm *.scen);;MovingAI map (*.map);;Binary map (*.pfgm);;MovingAI scenario (*.scen)");
+    if (path.isEmpty()) return;
+
+    QElapsedTimer timer;
+    timer.start();
+    std::string error;
+    Grid::Model model;
+    bool haveEndpoints = false;
+
+    QString mapPath = path;
+    if (path.endsWith(".scen", Qt::CaseInsensitive)) {
+        std::vector<pathfinding::Scenario> scenarios;
+        if (!pathfinding::loadMovingAiScenarios(QFile::encodeName(path).toStdString(), scenarios, &error)
+            || scenarios.empty()) {
+            QMessageBox::warning(this, "Open Map", error.empty() ? "Scenario file is empty" : QString::fromStdString(error));
+            return;
+        }
+        const auto &first = scenarios.front();
+        const QDir dir = QFileInfo(path).dir();
+        mapPath = dir.filePath(QString::fromStdString(first.mapFile));
+        if (!QFileInfo::exists(mapPath))
+            mapPath = dir.filePath(QFileInfo(QString::fromStdString(first.mapFile)).fileName());
+        model.start = QPoint(first.startY, first.startX);
+        model.target = QPoint(first.goalY, first.goalX);
+        haveEndpoints = true;
+    }
+
+    if (!pathfinding::loadMap(QFile::encodeName(mapPath).toStdString(), model.grid, &error)) {
+        QMessageBox::warning(this, "Open Map", QString::fromStdString(error));
+        return;
+    }
+    if (model.grid.rows() > Grid::MaxDimension || model.grid.cols() > Grid::MaxDimension) {
+        QMessageBox::warning(this, "Open Map", QString("Maps are limited to %1 x %1").arg(Grid::MaxDimension));
+        return;
+    }
+
+    if (!haveEndpoints) {
+        const int n = model.grid.size();
+        int first = 0, last = n - 1;
+        while (first < n && model.grid.isWall(first)) ++first;
+        while (last > first && model.grid.isWall(last)) --last;
+        model.start = QPoint(model.grid.rowOf(first % n), model.grid.colOf(first % n));
+        model.target = QPoint(model.grid.rowOf(last), model.grid.colOf(last));
+    }
+    const qint64 loadMs = timer.elapsed();
+
+    cancelAllRuns();
+    applyGridSize(model.grid.rows(), model.grid.cols());
+    m_grid->importModel(model);
+    if (m_componentsAction->isChecked()) requestComponents();
+    m_statusLabel->setText(QString("Loaded %1 (%2 x %3) in %4 ms")
+                               .arg(QFileInfo(mapPath).fileName())
+                               .arg(model.grid.rows()).arg(model.grid.cols()).arg(loadMs));
+}
+
+void MainWindow::onSaveMap() {
+    const QString path = QFileDialog::getSaveFileName(this, "Save Map", QString(),
+        "Binary map (*.pfgm);;MovingAI map (*.map)");
+    if (path.isEmpty()) return;
+
+    std::string error;
+    if (!pathfinding::saveMap(QFile::encodeName(path).toStdString(), m_grid->exportModel().grid, &error)) {
+        QMessageBox::warning(this, "Save Map", QString::fromStdString(error));
+        return;
+    }
+    m_statusLabel->setText("Saved " + QFileInfo(path).fileName());
+}
+
+/**
+ * Replays a saved trace over the current walls. Traces carry no map, only
+ * its size, so the walls are whatever the grid holds now.
+ */
+void MainWindow::onOpenTrace() {
+    const QString path = QFileDialog::getOpenFileName(this, "Open Trace", QString(), "Search trace (*.pftrace)");
+    if (path.isEmpty()) return;
+
+    auto trace = std::make_shared<pathfinding::SearchTrace>();
+    std::string error;
+    if (!pathfinding::loadTrace(QFile::encodeName(path).toStdString(), *trace, &error)) {
+        QMessageBox::warning(this, "Open Trace", QString::fromStdString(error));
+        return;
+    }
+    if (trace->rows != m_grid->rows() || trace->cols != m_grid->cols()) {
+        QMessageBox::warning(this, "Open Trace", QString("The trace was recorded on a %1 x %2 grid")
+                                                     .arg(trace->rows).arg(trace->cols));
+        return;
+    }
+
+    cancelAllRuns();
+    m_planActive = false;
+    m_replanPending = false;
+    auto model = m_grid->exportModel();
+    model.start = QPoint(trace->start / trace->cols, trace->start % trace->cols);
+    model.target = QPoint(trace->target / trace->cols, trace->target % trace->cols);
+    m_grid->importModel(model);
+    m_player->load(trace);
+    if (m_turbo) m_player->finish();
+    m_reportPanel->showTrace(*trace, QFileInfo(path).fileName());
+    m_statusLabel->setText(QString("Trace of %1: %2 nodes expanded in %3 ms, %4")
+                               .arg(pathfinding::algorithmName(trace->algorithm))
+                               .arg(trace->stats.nodesExpanded)
+                               .arg(trace->stats.elapsedMs, 0, 'f', 2)
+                               .arg(trace->found ? QString("path cost %1").arg(trace->pathCost) : QString("no path")));
+}
+
+void MainWindow::onSaveTrace() {
+    if (!m_player->trace()) {
+        m_statusLabel->setText("No trace to save: run a search first");
+        return;
+    }
+    const QString path = QFileDialog::getSaveFileName(this, "Save Trace", QString(), "Search trace (*.pftrace)");
+    if (path.isEmpty()) return;
+
+    std::string error;
+    if (!pathfinding::saveTrace(QFile::encodeName(path).toStdString(), *m_player->trace(), &error)) {
+        QMessageBox::warning(this, "Save Trace", QString::fromStdString(error));
+        return;
+    }
+    m_statusLabel->setText(QString("Saved %1 (%2 events)").arg(QFileInfo(path).fileName()).arg(m_player->length()));
+}
+
+/**
+ * Picks the largest cell size (up to the default) at which the whole grid fits
+ * the viewport, reallocates the grid and zooms to fit. Very large grids end up
+ * with 1-unit cells and a zoomed-out view.
+ */
+void MainWindow::applyGridSize(int rows, int cols) {
+    m_planActive = false;
+    m_replanPending = false;
+    const QSize viewport = m_view->viewport()->size();
+    const int fitCell = qMin(viewport.width() / qMax(1, cols), viewport.height() / qMax(1, rows));
+    m_grid->resize(rows, cols, qBound(1, fitCell, int(Grid::DefaultCellSize)));
+    fitGridToView();
+}
+
+void MainWindow::fitGridToView() {
+    m_view->resetTransform();
+    const QRectF rect = m_grid->scene()->sceneRect();
+    const QSize viewport = m_view->viewport()->size();
+    // Only scale down; grids that already fit keep their pixel-exact cells
+    if (rect.width() > viewport.width() || rect.height() > viewport.height())
+        m_view->fitInView(rect, Qt::KeepAspectRatio);
+    m_view->centerOn(rect.center());
+}
+
+/**
+ * The search is done when its trace arrives; from here on the player owns
+ * the animation. Turbo and replans skip straight to the end.
+ */
+void MainWindow::handleTrace(quint64 runId, const SearchTracePtr &trace) {
+    if (runId != m_runId) return;
+    m_player->load(trace);
+    if (m_turbo || m_drawAtOnce) m_player->finish();
+    m_reportPanel->showRun(*trace, m_runOptions);
+}
+
+void MainWindow::handlePathBatch(quint64 runId, const QVector<int> &cells) {
+    if (runId != m_runId) return;
+    m_grid->markPathCells(cells);
+}
+
+void MainWindow::handleDistanceField(quint64 runId, const QVector<int> &dist) {
+    if (runId != m_runId) return;
+    m_grid->showDistanceField(dist);
+}
+
+void MainWindow::handleComponentLabels(quint64 runId, const QVector<int> &labels) {
+    // Only the latest request matches the grid as it is now
+    if (runId != m_componentsRunId) return;
+    m_grid->showComponents(labels);
+    m_heatMapAction->setChecked(true); // the heat-map toggle shows and hides every overlay
 }
 
-void MainWindow::handlePathNode(int row, int col) {
-    m_grid->markPath(row, col);
+void MainWindow::handleSearchStats(quint64 runId, qint64 nodesExpanded, double elapsedMs) {
+    if (runId != m_runId) return;
+    m_lastRunSummary = QString("%1 nodes expanded in %2 ms")
+                           .arg(nodesExpanded)
+                           .arg(elapsedMs, 0, 'f', 2);
 }
 
-void MainWindow::handleWorkerFinished() {
+void MainWindow::handleScratchMemory(quint64 runId, qint64 bytes, int cells) {
+    if (runId != m_runId || cells <= 0) return;
+    m_lastRunSummary += QString(", scratch %1 B/cell (%2 MB)")
+                            .arg(double(bytes) / cells, 0, 'f', 1)
+                            .arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+void MainWindow::handleWorkerFinished(quint64 runId) {
+    if (runId != m_runId) return;
     m_isRunning = false;
-    m_statusLabel->setText("Finished");
+    if (m_batchRunning) {
+        m_batchRunning = false;
+        return; // the batch summary is already in the status bar
+    }
+    if (m_replanPending && m_planActive) {
+        startReplan();
+        return;
+    }
+    if (m_lastRunSummary.isEmpty())
+        m_statusLabel->setText("Finished");
+    else
+        m_statusLabel->setText("Finished - " + m_lastRunSummary);
 }
 
-void MainWindow::handleStatus(const QString &text) {
+void MainWindow::handleStatus(quint64 runId, const QString &text) {
+    if (runId == 0 || (runId != m_runId && runId != m_componentsRunId)) return;
     m_statusLabel->setText(text);
 }
 
 void MainWindow::keyPressEvent(QKeyEvent *event) {
     if (!event) return;
     if (event->key() == Qt::Key_Space) {
-        onRun();
+        if (event->modifiers() & Qt::ShiftModifier)
+            m_pauseAction->toggle();
+        else
+            onRun();
+    } else if (event->key() == Qt::Key_Period) {
+        onStep();
+    } else if (event->key() == Qt::Key_Comma) {
+        if (!m_pauseAction->isChecked()) m_pauseAction->setChecked(true);
+        m_player->stepBackward();
     } else if (event->key() == Qt::Key_R) {
         onReset();
     } else if (event->key() == Qt::Key_B) {
-        m_algoSelector->setCurrentText("BFS");
+        // Shift selects the bidirectional variant
+        m_algoSelector->setCurrentText((event->modifiers() & Qt::ShiftModifier) ? "Bidirectional BFS" : "BFS");
+    } else if (event->key() == Qt::Key_P) {
+        m_algoSelector->setCurrentText("Parallel BFS");
+    } else if (event->key() == Qt::Key_G) {
+        m_algoSelector->setCurrentText("Flow field");
+    } else if (event->key() == Qt::Key_N) {
+        // Any-angle: N = Theta*, Shift+N = Lazy Theta*
+        m_algoSelector->setCurrentText(pathfinding::algorithmName((event->modifiers() & Qt::ShiftModifier)
+                                                                      ? pathfinding::Algorithm::LazyThetaStar
+                                                                      : pathfinding::Algorithm::ThetaStar));
+    } else if (event->key() == Qt::Key_L) {
+        m_algoSelector->setCurrentText(pathfinding::algorithmName(pathfinding::Algorithm::DStarLite));
+    } else if (event->key() == Qt::Key_H) {
+        // Shift+H: hierarchical search, H: heat map
+        if (event->modifiers() & Qt::ShiftModifier)
+            m_algoSelector->setCurrentText(pathfinding::algorithmName(pathfinding::Algorithm::HPA));
+        else
+            m_heatMapAction->toggle();
+    } else if (event->key() == Qt::Key_C) {
+        // Shift+C: connected regions, C: HPA* clusters
+        if (event->modifiers() & Qt::ShiftModifier)
+            m_componentsAction->toggle();
+        else
+            m_clustersAction->toggle();
     } else if (event->key() == Qt::Key_D) {
         m_algoSelector->setCurrentText("Dijkstra");
     } else if (event->key() == Qt::Key_A) {
-        m_algoSelector->setCurrentText("A*");
+        m_algoSelector->setCurrentText((event->modifiers() & Qt::ShiftModifier) ? "Bidirectional A*" : "A*");
+    } else if (event->key() == Qt::Key_J) {
+        // J: cell-stepping JPS, Shift+J: block-based variant
+        const auto algo = (event->modifiers() & Qt::ShiftModifier) ? pathfinding::Algorithm::BlockJPS
+                                                                    : pathfinding::Algorithm::JPS;
+        m_algoSelector->setCurrentText(pathfinding::algorithmName(algo));
+    } else if (event->key() == Qt::Key_T) {
+        m_turboAction->toggle();
+    } else if (event->key() == Qt::Key_F) {
+        fitGridToView();
+    } else if (event->key() == Qt::Key_O && (event->modifiers() & Qt::ControlModifier)) {
+        onOpenMap();
+    } else if (event->key() == Qt::Key_S && (event->modifiers() & Qt::ControlModifier)) {
+        onSaveMap();
     } else {
         QMainWindow::keyPressEvent(event);
     }
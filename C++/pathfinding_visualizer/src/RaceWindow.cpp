@@ -0,0 +1,410 @@
+#include "RaceWindow.hpp"
+#include "GridView.hpp"
+#include "TracePlayer.hpp"
+
+#include <QComboBox>
+#include <QFrame>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QListWidget>
+#include <QListWidgetItem>
+#include <QMetaObject>
+#include <QPushButton>
+#include <QResizeEvent>
+#include <QStringList>
+#include <QVBoxLayout>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+// Visited-cell colors of the racers, light enough that the gold path stays visible
+const QColor kRacerColors[] = {
+    QColor(135, 206, 250), // light sky blue
+    QColor(144, 238, 144), // light green
+    QColor(221, 160, 221), // plum
+    QColor(255, 160, 122), // light salmon
+    QColor(127, 255, 212), // aquamarine
+    QColor(176, 196, 222), // light steel blue
+    QColor(255, 218, 185), // peach
+    QColor(216, 191, 216), // thistle
+};
+
+// How often the panes of running searches read their worker's expansion count
+const int kProgressMs = 100;
+// The slowest racer's replay lasts about this long; the others finish in proportion
+const double kRaceReplayMs = 4000.0;
+const double kMinReplayMs = 50.0;
+// Cells of a pane's grid fit in about this many pixels before the view scales down
+const int kPaneCellBudget = 600;
+
+enum Pace { PaceByTime, PaceByExpansions };
+
+} // namespace
+
+RaceWindow::RaceWindow(QWidget *parent)
+    : QWidget(parent, Qt::Window)
+{
+    setWindowTitle("Algorithm Race");
+    resize(1200, 800);
+
+    m_algoList = new QListWidget(this);
+    m_algoList->setFixedWidth(200);
+    m_algoList->setToolTip("Algorithms in the race; each one searches on its own thread");
+    // Item data is the pathfinding::Algorithm passed to the worker
+    for (auto algo : {pathfinding::Algorithm::BFS, pathfinding::Algorithm::Dijkstra, pathfinding::Algorithm::AStar,
+                      pathfinding::Algorithm::JPS, pathfinding::Algorithm::BlockJPS,
+                      pathfinding::Algorithm::BidirectionalBFS, pathfinding::Algorithm::BidirectionalAStar,
+                      pathfinding::Algorithm::ParallelBFS, pathfinding::Algorithm::FlowField,
+                      pathfinding::Algorithm::DStarLite, pathfinding::Algorithm::HPA,
+                      pathfinding::Algorithm::ThetaStar, pathfinding::Algorithm::LazyThetaStar}) {
+        auto *item = new QListWidgetItem(pathfinding::algorithmName(algo), m_algoList);
+        item->setData(Qt::UserRole, static_cast<int>(algo));
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        const bool classic = algo == pathfinding::Algorithm::BFS || algo == pathfinding::Algorithm::Dijkstra
+            || algo == pathfinding::Algorithm::AStar;
+        item->setCheckState(classic ? Qt::Checked : Qt::Unchecked);
+    }
+
+    m_paceSelector = new QComboBox(this);
+    m_paceSelector->addItem("Pace: search time", PaceByTime);
+    m_paceSelector->addItem("Pace: expansions", PaceByExpansions);
+    m_paceSelector->setToolTip("Replay each search in proportion to its measured time, or to the cells it expanded");
+
+    m_startButton = new QPushButton("Start", this);
+    m_replayButton = new QPushButton("Replay", this);
+    m_snapshotLabel = new QLabel("No snapshot", this);
+    m_snapshotLabel->setWordWrap(true);
+    m_summaryLabel = new QLabel("Pick the algorithms and press Start", this);
+    m_summaryLabel->setWordWrap(true);
+
+    m_panes = new QWidget(this);
+    m_paneLayout = new QGridLayout(m_panes);
+    m_paneLayout->setContentsMargins(0, 0, 0, 0);
+
+    auto *controls = new QVBoxLayout;
+    controls->addWidget(m_snapshotLabel);
+    controls->addWidget(m_algoList, 1);
+    controls->addWidget(m_paceSelector);
+    controls->addWidget(m_startButton);
+    controls->addWidget(m_replayButton);
+    controls->addWidget(m_summaryLabel);
+    auto *layout = new QHBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(m_panes, 1);
+
+    m_progressTimer.setInterval(kProgressMs);
+    connect(&m_progressTimer, &QTimer::timeout, this, &RaceWindow::onProgressTick);
+    connect(m_startButton, &QPushButton::clicked, this, [this]() { racing() ? stop() : start(); });
+    connect(m_replayButton, &QPushButton::clicked, this, &RaceWindow::replay);
+    connect(m_paceSelector, &QComboBox::currentIndexChanged, this, &RaceWindow::replay);
+    updateControls();
+}
+
+RaceWindow::~RaceWindow() {
+    for (const Lane &lane : m_lanes) {
+        lane.worker->cancelRuns(m_nextRunId);
+        lane.thread->quit();
+        lane.thread->wait();
+        delete lane.worker;
+    }
+}
+
+void RaceWindow::setSnapshot(const Grid::Model &model, const pathfinding::SearchOptions &options) {
+    stop();
+    clearRacers();
+    m_model = model;
+    // Read by every racer's thread at once, version() included; GridMap only writes its version when edited
+    m_snapshot = std::make_shared<const pathfinding::GridMap>(model.grid);
+    m_options = options;
+    m_snapshotLabel->setText(QString("Snapshot: %1 x %2, start (%3, %4), target (%5, %6)")
+                                 .arg(model.grid.rows()).arg(model.grid.cols())
+                                 .arg(model.start.x()).arg(model.start.y())
+                                 .arg(model.target.x()).arg(model.target.y()));
+    m_summaryLabel->setText("Pick the algorithms and press Start");
+    updateControls();
+}
+
+/**
+ * Sends every racer's search at once, one per worker thread, all over the
+ * same shared snapshot. Each worker gets the window's options first, queued
+ * ahead of the search like the main window does.
+ */
+void RaceWindow::start() {
+    if (!m_snapshot || racing()) return;
+    QVector<pathfinding::Algorithm> algorithms;
+    for (int row = 0; row < m_algoList->count(); ++row) {
+        const QListWidgetItem *item = m_algoList->item(row);
+        if (item->checkState() == Qt::Checked)
+            algorithms.push_back(pathfinding::Algorithm(item->data(Qt::UserRole).toInt()));
+    }
+    if (algorithms.isEmpty()) {
+        m_summaryLabel->setText("Pick at least one algorithm");
+        return;
+    }
+
+    clearRacers();
+    m_racers.resize(algorithms.size());
+    for (int i = 0; i < m_racers.size(); ++i) {
+        m_racers[i].algorithm = algorithms[i];
+        m_racers[i].color = kRacerColors[std::size_t(i) % std::size(kRacerColors)];
+    }
+    ensureLanes(m_racers.size());
+    buildPanes();
+
+    for (int i = 0; i < m_racers.size(); ++i) {
+        Racer &racer = m_racers[i];
+        AlgorithmWorker *worker = m_lanes[i].worker;
+        racer.runId = ++m_nextRunId;
+        QMetaObject::invokeMethod(worker, "setSearchOptions", Qt::QueuedConnection,
+                                  Q_ARG(pathfinding::SearchOptions, m_options));
+        QMetaObject::invokeMethod(worker, "runSharedSearch", Qt::QueuedConnection,
+                                  Q_ARG(quint64, racer.runId),
+                                  Q_ARG(int, static_cast<int>(racer.algorithm)),
+                                  Q_ARG(GridMapPtr, m_snapshot),
+                                  Q_ARG(QPoint, m_model.start),
+                                  Q_ARG(QPoint, m_model.target));
+        racer.clock.start();
+    }
+    m_progressTimer.start();
+
+    const int cores = QThread::idealThreadCount();
+    m_summaryLabel->setText(QString("Racing %1 algorithms on %1 threads").arg(m_racers.size())
+                            + (m_racers.size() > cores
+                                   ? QString(" - more racers than the %1 cores, so times include waiting for one")
+                                         .arg(cores)
+                                   : QString()));
+    updateControls();
+}
+
+// The workers report every cancelled run as finished, which ends the race as usual
+void RaceWindow::stop() {
+    if (!racing()) return;
+    for (const Lane &lane : m_lanes)
+        lane.worker->cancelRuns(m_nextRunId);
+    m_summaryLabel->setText("Stopping...");
+}
+
+void RaceWindow::replay() {
+    if (racing() || m_racers.isEmpty()) return;
+    startReplay();
+}
+
+void RaceWindow::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    fitViews();
+}
+
+void RaceWindow::ensureLanes(int count) {
+    while (m_lanes.size() < count) {
+        Lane lane;
+        lane.worker = new AlgorithmWorker();
+        lane.thread = new QThread(this);
+        lane.worker->moveToThread(lane.thread);
+        lane.thread->start();
+        connect(lane.worker, &AlgorithmWorker::traceRecorded, this, &RaceWindow::handleTrace);
+        connect(lane.worker, &AlgorithmWorker::status, this, &RaceWindow::handleStatus);
+        connect(lane.worker, &AlgorithmWorker::finished, this, &RaceWindow::handleWorkerFinished);
+        m_lanes.push_back(lane);
+    }
+}
+
+void RaceWindow::clearRacers() {
+    m_progressTimer.stop();
+    // Views first: each one shows a scene its racer's grid owns
+    while (QLayoutItem *item = m_paneLayout->takeAt(0)) {
+        delete item->widget();
+        delete item;
+    }
+    for (Racer &racer : m_racers)
+        delete racer.grid; // also deletes its player
+    m_racers.clear();
+    updateControls();
+}
+
+/**
+ * One pane per racer, in a near-square grid: the algorithm's name on its
+ * color, a read-only copy of the snapshot and a line of live stats.
+ */
+void RaceWindow::buildPanes() {
+    const int rows = m_model.grid.rows();
+    const int cols = m_model.grid.cols();
+    const int columns = int(std::ceil(std::sqrt(double(m_racers.size()))));
+    const int cellSize = qBound(1, kPaneCellBudget / std::max(1, std::max(rows, cols)), int(Grid::DefaultCellSize));
+
+    for (int i = 0; i < m_racers.size(); ++i) {
+        Racer &racer = m_racers[i];
+        auto *pane = new QFrame(m_panes);
+        pane->setFrameShape(QFrame::StyledPanel);
+        auto *title = new QLabel(pathfinding::algorithmName(racer.algorithm), pane);
+        title->setStyleSheet(QString("background-color: %1; padding: 2px; font-weight: bold;")
+                                 .arg(racer.color.name()));
+
+        racer.grid = new Grid(1, 1, this);
+        racer.grid->setEditable(false);
+        racer.grid->resize(rows, cols, cellSize);
+        racer.grid->importModel(m_model);
+        racer.grid->setVisitedColor(racer.color);
+        racer.view = new GridView(racer.grid->scene(), pane);
+        racer.stats = new QLabel("Waiting for a thread...", pane);
+        racer.player = new TracePlayer(racer.grid, racer.grid);
+        connect(racer.player, &TracePlayer::positionChanged, this,
+                [this, i](qint64 position, qint64) { showReplayPosition(i, position); });
+        connect(racer.player, &TracePlayer::playbackFinished, this, [this, i]() { showResult(i); });
+
+        auto *layout = new QVBoxLayout(pane);
+        layout->setContentsMargins(2, 2, 2, 2);
+        layout->addWidget(title);
+        layout->addWidget(racer.view, 1);
+        layout->addWidget(racer.stats);
+        m_paneLayout->addWidget(pane, i / columns, i % columns);
+    }
+    // The views only have their final size once the layout has run
+    QTimer::singleShot(0, this, &RaceWindow::fitViews);
+}
+
+// Same as the main window's Fit: only scale down, so small grids keep pixel-exact cells
+void RaceWindow::fitViews() {
+    for (const Racer &racer : m_racers) {
+        if (!racer.view) continue;
+        racer.view->resetTransform();
+        const QRectF rect = racer.grid->scene()->sceneRect();
+        const QSize viewport = racer.view->viewport()->size();
+        if (rect.width() > viewport.width() || rect.height() > viewport.height())
+            racer.view->fitInView(rect, Qt::KeepAspectRatio);
+        racer.view->centerOn(rect.center());
+    }
+}
+
+/**
+ * Replays every trace at once. Paced by time, each replay lasts in
+ * proportion to its measured search time; paced by expansions, in
+ * proportion to its expanded cells. Either way the slowest takes
+ * kRaceReplayMs, so the order in which the panes finish is the ranking.
+ */
+void RaceWindow::startReplay() {
+    double longestMs = 0.0;
+    qint64 mostVisits = 0;
+    for (const Racer &racer : m_racers) {
+        if (!racer.trace) continue;
+        longestMs = std::max(longestMs, racer.searchMs);
+        mostVisits = std::max(mostVisits, racer.visits);
+    }
+    const bool byTime = m_paceSelector->currentData().toInt() == PaceByTime;
+    for (Racer &racer : m_racers) {
+        if (!racer.trace) continue;
+        const double share = byTime ? (longestMs > 0.0 ? racer.searchMs / longestMs : 1.0)
+                                    : (mostVisits > 0 ? double(racer.visits) / double(mostVisits) : 1.0);
+        racer.player->setDurationMs(std::max(kMinReplayMs, kRaceReplayMs * share));
+        racer.player->load(racer.trace);
+    }
+
+    QVector<int> order;
+    for (int i = 0; i < m_racers.size(); ++i)
+        if (m_racers[i].trace) order.push_back(i);
+    std::sort(order.begin(), order.end(),
+              [this](int a, int b) { return m_racers[a].searchMs < m_racers[b].searchMs; });
+    QStringList ranking;
+    for (int i : order) {
+        const Racer &racer = m_racers[i];
+        const double best = m_racers[order.first()].searchMs;
+        ranking << QString("%1. %2: %3 ms").arg(ranking.size() + 1).arg(pathfinding::algorithmName(racer.algorithm))
+                       .arg(racer.searchMs, 0, 'f', 2)
+                       + (best > 0.0 && i != order.first() ? QString(" (%1x)").arg(racer.searchMs / best, 0, 'f', 1)
+                                                           : QString());
+    }
+    m_summaryLabel->setText(ranking.isEmpty() ? QString("No search finished") : ranking.join("\n"));
+    updateControls();
+}
+
+void RaceWindow::handleTrace(quint64 runId, const SearchTracePtr &trace) {
+    const int i = racerOf(runId);
+    if (i < 0) return;
+    Racer &racer = m_racers[i];
+    racer.trace = trace;
+    racer.searchMs = trace->stats.elapsedMs;
+    racer.visits = 0;
+    for (std::uint32_t event : trace->events)
+        if (pathfinding::SearchTrace::kindOf(event) != pathfinding::SearchTrace::Path) ++racer.visits;
+}
+
+void RaceWindow::handleStatus(quint64 runId, const QString &text) {
+    const int i = racerOf(runId);
+    if (i >= 0) m_racers[i].note = text;
+}
+
+/**
+ * A racer's trace arrives just before its finished signal. The replay
+ * starts once the last racer is done, so every pane starts together.
+ */
+void RaceWindow::handleWorkerFinished(quint64 runId) {
+    const int i = racerOf(runId);
+    if (i < 0) return;
+    Racer &racer = m_racers[i];
+    racer.finished = true;
+    if (racer.trace)
+        racer.stats->setText(QString("Done: %L1 expanded in %2 ms, waiting for the others")
+                                 .arg(racer.trace->stats.nodesExpanded)
+                                 .arg(racer.searchMs, 0, 'f', 2));
+    else
+        racer.stats->setText(racer.note.isEmpty() ? QString("No result") : racer.note);
+    if (racing()) return;
+    m_progressTimer.stop();
+    startReplay();
+}
+
+void RaceWindow::onProgressTick() {
+    for (int i = 0; i < m_racers.size(); ++i) {
+        const Racer &racer = m_racers[i];
+        if (racer.finished || racer.trace) continue;
+        racer.stats->setText(QString("Searching: %L1 expanded, %2 ms")
+                                 .arg(m_lanes[i].worker->expandedSoFar(racer.runId))
+                                 .arg(racer.clock.elapsed()));
+    }
+}
+
+// Replay time runs linearly through the events, so the clock shown is that share of the measured search time
+void RaceWindow::showReplayPosition(int i, qint64 position) {
+    const Racer &racer = m_racers[i];
+    if (!racer.trace || racer.trace->events.empty()) return;
+    const double ms = racer.searchMs * double(position) / double(racer.trace->events.size());
+    racer.stats->setText(QString("%L1 expanded, %2 ms").arg(std::min(position, racer.visits)).arg(ms, 0, 'f', 2));
+}
+
+void RaceWindow::showResult(int i) {
+    const Racer &racer = m_racers[i];
+    if (!racer.trace) return;
+    int rank = 1;
+    for (const Racer &other : m_racers)
+        if (other.trace && other.searchMs < racer.searchMs) ++rank;
+    racer.stats->setText(QString("#%1: %L2 expanded in %3 ms, %4")
+                             .arg(rank)
+                             .arg(racer.trace->stats.nodesExpanded)
+                             .arg(racer.searchMs, 0, 'f', 2)
+                             .arg(racer.trace->found ? QString("path cost %1").arg(racer.trace->pathCost)
+                                                     : QString("no path")));
+}
+
+void RaceWindow::updateControls() {
+    const bool busy = racing();
+    const bool haveTrace = std::any_of(m_racers.begin(), m_racers.end(),
+                                       [](const Racer &racer) { return bool(racer.trace); });
+    m_startButton->setText(busy ? "Stop" : "Start");
+    m_startButton->setEnabled(m_snapshot != nullptr);
+    m_replayButton->setEnabled(!busy && haveTrace);
+    m_algoList->setEnabled(!busy);
+}
+
+int RaceWindow::racerOf(quint64 runId) const {
+    for (int i = 0; i < m_racers.size(); ++i)
+        if (m_racers[i].runId == runId) return i;
+    return -1;
+}
+
+bool RaceWindow::racing() const {
+    return std::any_of(m_racers.begin(), m_racers.end(),
+                       [](const Racer &racer) { return racer.runId != 0 && !racer.finished; });
+}
@@ -0,0 +1,186 @@
+#include "RunReportPanel.hpp"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFont>
+#include <QHeaderView>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace {
+
+QJsonArray cellJson(const pathfinding::SearchTrace &trace, int cell) {
+    return QJsonArray{cell / trace.cols, cell % trace.cols};
+}
+
+// Everything the trace knows about its run; counters only when they were measured
+QJsonObject traceJson(const pathfinding::SearchTrace &trace) {
+    using pathfinding::SearchTrace;
+    qint64 pathCells = 0;
+    for (auto it = trace.events.rbegin(); it != trace.events.rend() && SearchTrace::kindOf(*it) == SearchTrace::Path;
+         ++it)
+        ++pathCells;
+
+    QJsonObject report;
+    report["algorithm"] = pathfinding::algorithmName(trace.algorithm);
+    report["rows"] = trace.rows;
+    report["cols"] = trace.cols;
+    report["start"] = cellJson(trace, trace.start);
+    report["target"] = cellJson(trace, trace.target);
+    report["found"] = trace.found;
+    report["path_cost"] = trace.pathCost;
+    report["path_cells"] = pathCells;
+    report["nodes_expanded"] = qint64(trace.stats.nodesExpanded);
+    report["nodes_generated"] = qint64(trace.stats.nodesGenerated);
+    report["elapsed_ms"] = trace.stats.elapsedMs;
+
+    const pathfinding::SearchCounters &c = trace.stats.counters;
+    if (c.measured) {
+        QJsonObject counters;
+        counters["pushes"] = qint64(c.pushes);
+        counters["pops"] = qint64(c.pops);
+        counters["stale_pops"] = qint64(c.stalePops);
+        counters["peak_open"] = qint64(c.peakOpen);
+        counters["bytes_allocated"] = qint64(c.bytesAllocated);
+        counters["search_ms"] = c.searchMs;
+        counters["path_ms"] = c.pathMs;
+        report["counters"] = counters;
+    }
+    return report;
+}
+
+QString bytesText(qint64 bytes) {
+    if (bytes >= 1024 * 1024) return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 2);
+    if (bytes >= 1024) return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    return QString("%1 B").arg(bytes);
+}
+
+QString shareText(double part, double whole) {
+    return whole > 0 ? QString(" (%1%)").arg(100.0 * part / whole, 0, 'f', 1) : QString();
+}
+
+} // namespace
+
+RunReportPanel::RunReportPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    m_tree = new QTreeWidget(this);
+    m_tree->setColumnCount(2);
+    m_tree->setHeaderLabels({"Metric", "Value"});
+    m_tree->setRootIsDecorated(false);
+    m_tree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+
+    m_exportButton = new QPushButton("Export JSON...", this);
+    m_exportButton->setToolTip("Save this report as a JSON object");
+    connect(m_exportButton, &QPushButton::clicked, this, &RunReportPanel::onExport);
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->addWidget(m_tree);
+    layout->addWidget(m_exportButton);
+    clear();
+}
+
+void RunReportPanel::showRun(const pathfinding::SearchTrace &trace, const pathfinding::SearchOptions &options) {
+    m_report = traceJson(trace);
+    m_report["source"] = "run";
+    m_report["open_list"] = pathfinding::queueKindName(options.queue);
+    m_report["movement"] = options.connectivity == pathfinding::Connectivity::Four
+        ? QString("4-way")
+        : QString("8-way, corner cutting %1").arg(pathfinding::cornerCuttingName(options.corners));
+    populate();
+}
+
+void RunReportPanel::showTrace(const pathfinding::SearchTrace &trace, const QString &fileName) {
+    m_report = traceJson(trace);
+    m_report["source"] = fileName;
+    populate();
+}
+
+void RunReportPanel::clear() {
+    m_report = QJsonObject();
+    populate();
+}
+
+void RunReportPanel::populate() {
+    // Read through a const reference: QJsonObject::operator[] would insert missing keys
+    const QJsonObject &report = m_report;
+    m_tree->clear();
+    m_exportButton->setEnabled(!report.isEmpty());
+    if (report.isEmpty()) {
+        new QTreeWidgetItem(m_tree, {"No run yet", QString()});
+        return;
+    }
+
+    auto row = [this](const QString &metric, const QString &value) {
+        new QTreeWidgetItem(m_tree, {metric, value});
+    };
+    auto section = [this](const QString &title) {
+        auto *item = new QTreeWidgetItem(m_tree, {title, QString()});
+        QFont font = item->font(0);
+        font.setBold(true);
+        item->setFont(0, font);
+    };
+    auto count = [](const QJsonObject &object, const char *key) {
+        return QString::number(qint64(object[key].toDouble()));
+    };
+
+    section("Run");
+    row("Algorithm", report["algorithm"].toString());
+    row("Source", report["source"].toString());
+    row("Grid", QString("%1 x %2").arg(report["rows"].toInt()).arg(report["cols"].toInt()));
+    if (report.contains("open_list")) row("Open list", report["open_list"].toString());
+    if (report.contains("movement")) row("Movement", report["movement"].toString());
+    row("Result", report["found"].toBool() ? QString("path cost %1, %2 cells")
+                                                   .arg(report["path_cost"].toInt())
+                                                   .arg(count(report, "path_cells"))
+                                             : QString("no path"));
+
+    section("Work");
+    row("Nodes expanded", count(report, "nodes_expanded"));
+    row("Nodes generated", count(report, "nodes_generated"));
+
+    const double elapsedMs = report["elapsed_ms"].toDouble();
+    if (!report.contains("counters")) {
+        section("Time");
+        row("Total", QString("%1 ms").arg(elapsedMs, 0, 'f', 3));
+        row("Counters", report["source"].toString() == "run" ? "not measured (panel was hidden)"
+                                                               : "not stored in trace files");
+        return;
+    }
+
+    const QJsonObject counters = report["counters"].toObject();
+    const double pops = counters["pops"].toDouble();
+    section("Open list");
+    row("Pushes", count(counters, "pushes"));
+    row("Pops", count(counters, "pops"));
+    row("Stale pops skipped", count(counters, "stale_pops") + shareText(counters["stale_pops"].toDouble(), pops));
+    row("Peak size", count(counters, "peak_open"));
+
+    section("Time");
+    row("Total", QString("%1 ms").arg(elapsedMs, 0, 'f', 3));
+    row("Search", QString("%1 ms").arg(counters["search_ms"].toDouble(), 0, 'f', 3)
+                      + shareText(counters["search_ms"].toDouble(), elapsedMs));
+    row("Path reconstruction", QString("%1 ms").arg(counters["path_ms"].toDouble(), 0, 'f', 3)
+                                   + shareText(counters["path_ms"].toDouble(), elapsedMs));
+
+    section("Memory");
+    row("Allocated", bytesText(qint64(counters["bytes_allocated"].toDouble())));
+}
+
+void RunReportPanel::onExport() {
+    if (m_report.isEmpty()) return;
+    const QString path = QFileDialog::getSaveFileName(this, "Export Run Report", QString(), "JSON (*.json)");
+    if (path.isEmpty()) return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(QJsonDocument(m_report).toJson(QJsonDocument::Indented)) < 0) {
+        QMessageBox::warning(this, "Export Run Report", QString("Cannot write %1").arg(QFileInfo(path).fileName()));
+    }
+}
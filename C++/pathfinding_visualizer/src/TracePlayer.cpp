@@ -0,0 +1,131 @@
+#include "TracePlayer.hpp"
+#include "Grid.hpp"
+
+#include <QVector>
+
+#include <algorithm>
+
+namespace {
+
+// One GUI frame at 60 fps; each tick draws the events due since the last one
+const int kFrameMs = 16;
+// At delay 0 a whole trace plays in about this long, however long it is
+const double kFastPlaybackMs = 1000.0;
+
+} // namespace
+
+TracePlayer::TracePlayer(Grid *grid, QObject *parent)
+    : QObject(parent), m_grid(grid)
+{
+    m_timer.setInterval(kFrameMs);
+    connect(&m_timer, &QTimer::timeout, this, &TracePlayer::onFrame);
+}
+
+void TracePlayer::load(const SearchTracePtr &trace) {
+    m_trace = trace;
+    m_position = 0;
+    m_credit = 0.0;
+    m_grid->clearSearchMarks();
+    emit positionChanged(m_position, length());
+    updateTimer();
+}
+
+void TracePlayer::clear() {
+    m_trace.reset();
+    m_position = 0;
+    m_timer.stop();
+    emit positionChanged(0, 0);
+}
+
+void TracePlayer::setDelayMs(int ms) {
+    m_delayMs = std::max(0, ms);
+    m_credit = 0.0;
+}
+
+void TracePlayer::setDurationMs(double ms) {
+    m_durationMs = std::max(0.0, ms);
+    m_credit = 0.0;
+}
+
+void TracePlayer::setPaused(bool paused) {
+    m_paused = paused;
+    updateTimer();
+}
+
+void TracePlayer::seek(qint64 position) {
+    if (!m_trace) return;
+    position = std::clamp<qint64>(position, 0, length());
+    if (position < m_position) {
+        m_grid->clearSearchMarks();
+        apply(0, position);
+    } else if (position > m_position) {
+        apply(m_position, position);
+    }
+    m_position = position;
+    m_credit = 0.0;
+    emit positionChanged(m_position, length());
+    updateTimer();
+}
+
+void TracePlayer::updateTimer() {
+    if (m_trace && !m_paused && m_position < length()) {
+        if (!m_timer.isActive()) {
+            m_clock.start();
+            m_timer.start();
+        }
+    } else {
+        m_timer.stop();
+    }
+}
+
+void TracePlayer::onFrame() {
+    if (!m_trace) { m_timer.stop(); return; }
+    // Measured rather than assumed frame time, so a slow repaint does not slow the replay down
+    const double elapsed = double(m_clock.restart());
+    if (m_durationMs > 0.0)
+        m_credit += length() * elapsed / m_durationMs;
+    else
+        m_credit += m_delayMs > 0 ? elapsed / m_delayMs : length() * elapsed / kFastPlaybackMs;
+    const qint64 due = qint64(m_credit);
+    if (due == 0) return;
+    m_credit -= double(due);
+
+    const qint64 to = std::min(length(), m_position + due);
+    apply(m_position, to);
+    m_position = to;
+    emit positionChanged(m_position, length());
+    if (m_position >= length()) {
+        m_timer.stop();
+        emit playbackFinished();
+    }
+}
+
+void TracePlayer::apply(qint64 from, qint64 to) {
+    using pathfinding::SearchTrace;
+    const auto &events = m_trace->events;
+    // One grid update per kind: bidirectional searches alternate sides every event
+    QVector<int> visits, backward, path;
+    for (qint64 i = from; i < to; ++i) {
+        const std::uint32_t event = events[std::size_t(i)];
+        switch (SearchTrace::kindOf(event)) {
+        case SearchTrace::Visit: visits.push_back(SearchTrace::cellOf(event)); break;
+        case SearchTrace::VisitBackward: backward.push_back(SearchTrace::cellOf(event)); break;
+        default: path.push_back(SearchTrace::cellOf(event)); break;
+        }
+    }
+    if (!visits.isEmpty()) m_grid->markVisitedCells(visits);
+    if (!backward.isEmpty()) m_grid->markBackwardVisitedCells(backward);
+    if (path.isEmpty()) return;
+    if (!pathfinding::isAnyAngle(m_trace->algorithm)) {
+        m_grid->markPathCells(path);
+        return;
+    }
+    // The corners form one line: redraw it through every corner shown so far
+    qint64 first = from;
+    while (first > 0 && SearchTrace::kindOf(events[std::size_t(first - 1)]) == SearchTrace::Path) --first;
+    path.clear();
+    for (qint64 i = first; i < to; ++i)
+        if (SearchTrace::kindOf(events[std::size_t(i)]) == SearchTrace::Path)
+            path.push_back(SearchTrace::cellOf(events[std::size_t(i)]));
+    m_grid->showPathPolyline(path);
+}
@@ -1,19 +1,32 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QMetaType>
-#include <QVector>
 #include <QPoint>
 #include "MainWindow.hpp"
-
-// Register meta types used in queued connections
-Q_DECLARE_METATYPE(QVector<QVector<int>>)
+#include "Grid.hpp"
+#include "Algorithms/AlgorithmWorker.hpp"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
 
-    qRegisterMetaType<QVector<QVector<int>>>("QVector<QVector<int>>");
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Pathfinding Visualizer");
+    parser.addHelpOption();
+    const QString range = QString("%1-%2").arg(Grid::MinDimension).arg(Grid::MaxDimension);
+    QCommandLineOption rowsOption("rows", QString("Grid rows (%1).").arg(range), "n", "30");
+    QCommandLineOption colsOption("cols", QString("Grid columns (%1).").arg(range), "n", "50");
+    parser.addOption(rowsOption);
+    parser.addOption(colsOption);
+    parser.process(app);
+
+    // Register meta types used in queued connections
+    qRegisterMetaType<pathfinding::GridMap>("pathfinding::GridMap");
+    qRegisterMetaType<pathfinding::SearchOptions>("pathfinding::SearchOptions");
     qRegisterMetaType<QPoint>("QPoint");
+    qRegisterMetaType<SearchTracePtr>("SearchTracePtr");
+    qRegisterMetaType<GridMapPtr>("GridMapPtr");
 
-    MainWindow w;
+    MainWindow w(parser.value(rowsOption).toInt(), parser.value(colsOption).toInt());
     w.show();
     return app.exec();
 }